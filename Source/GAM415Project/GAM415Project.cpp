@@ -3,4 +3,6 @@
 #include "GAM415Project.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogGAM415Project);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, GAM415Project, "GAM415Project" );
@@ -0,0 +1,120 @@
+#include "DigDebugDraw.h"
+
+#if ENABLE_DRAW_DEBUG
+
+#include "DigShotSubsystem.h"
+#include "DrawDebugHelpers.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarDigDebug(
+    TEXT("Dig.Debug"),
+    0,
+    TEXT("Dig shot debug drawing.\n")
+    TEXT(" 0: off\n")
+    TEXT(" 1: draw each shot's trace and dig radius (capped by Dig.Debug.MaxShotsPerFrame)\n")
+    TEXT(" 2: draw a heatmap of recent dig locations (capped by Dig.Debug.HeatmapBudget)"),
+    ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarDigDebugMaxShotsPerFrame(
+    TEXT("Dig.Debug.MaxShotsPerFrame"),
+    32,
+    TEXT("Maximum number of individual dig shots drawn per frame in Dig.Debug 1."),
+    ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarDigDebugHeatmapBudget(
+    TEXT("Dig.Debug.HeatmapBudget"),
+    64,
+    TEXT("Maximum number of heatmap cells drawn per frame in Dig.Debug 2; the hottest cells win."),
+    ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarDigDebugHeatmapCellSize(
+    TEXT("Dig.Debug.HeatmapCellSize"),
+    250.0f,
+    TEXT("World size of a dig heatmap cell."),
+    ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarDigDebugHeatmapHalfLife(
+    TEXT("Dig.Debug.HeatmapHalfLife"),
+    2.0f,
+    TEXT("Seconds for a heatmap cell to cool to half its heat."),
+    ECVF_Cheat);
+
+void FDigDebugDraw::AddShot(UWorld* World, const FDigShot& Shot, const FHitResult* Hit, bool bDugTerrain)
+{
+    const int32 Mode = CVarDigDebug.GetValueOnGameThread();
+
+    if (Mode == 1)
+    {
+        if (NumShotsDrawnThisFrame >= CVarDigDebugMaxShotsPerFrame.GetValueOnGameThread()) return;
+        NumShotsDrawnThisFrame++;
+
+        if (bDugTerrain)
+        {
+            // Draw a green debug sphere to visualize the radius.
+            DrawDebugSphere(World, Hit->Location, Shot.DigRadius, 12, FColor::Green, false, 1.0f);
+        }
+
+        // Determine the endpoint for the debug line: either the hit location or the full trace length.
+        const FVector LineStop = Hit ? Hit->Location : Shot.Start + Shot.Direction * Shot.MaxDistance;
+        // Draw a red debug line representing the trace.
+        DrawDebugLine(World, Shot.Start, LineStop, FColor::Red, false, 1.0f, 0, 2.0f);
+    }
+    else if (Mode == 2 && bDugTerrain)
+    {
+        const float CellSize = FMath::Max(CVarDigDebugHeatmapCellSize.GetValueOnGameThread(), 1.0f);
+        const FIntPoint CellCoords(FMath::FloorToInt(Hit->Location.X / CellSize), FMath::FloorToInt(Hit->Location.Y / CellSize));
+
+        FHeatCell& Cell = HeatCells.FindOrAdd(CellCoords);
+        Cell.Heat += 1.0f;
+        Cell.Z = Hit->Location.Z;
+    }
+}
+
+void FDigDebugDraw::Tick(UWorld* World, float DeltaTime)
+{
+    NumShotsDrawnThisFrame = 0;
+
+    if (CVarDigDebug.GetValueOnGameThread() != 2)
+    {
+        HeatCells.Reset();
+        return;
+    }
+    if (HeatCells.IsEmpty()) return;
+
+    // Cool every cell and forget the ones that went cold.
+    const float HalfLife = FMath::Max(CVarDigDebugHeatmapHalfLife.GetValueOnGameThread(), 0.01f);
+    const float Decay = FMath::Exp2(-DeltaTime / HalfLife);
+    for (auto It = HeatCells.CreateIterator(); It; ++It)
+    {
+        It.Value().Heat *= Decay;
+        if (It.Value().Heat < 0.05f)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    // Pick the hottest cells that fit the budget.
+    TArray<TPair<FIntPoint, FHeatCell>> DrawnCells = HeatCells.Array();
+    const int32 Budget = FMath::Max(CVarDigDebugHeatmapBudget.GetValueOnGameThread(), 0);
+    if (DrawnCells.Num() > Budget)
+    {
+        DrawnCells.Sort([](const TPair<FIntPoint, FHeatCell>& A, const TPair<FIntPoint, FHeatCell>& B)
+        {
+            return A.Value.Heat > B.Value.Heat;
+        });
+        DrawnCells.SetNum(Budget);
+    }
+
+    // Draw each cell as a flat box for this frame only, colored from blue (cool) to red (hot).
+    const float CellSize = FMath::Max(CVarDigDebugHeatmapCellSize.GetValueOnGameThread(), 1.0f);
+    for (const TPair<FIntPoint, FHeatCell>& Cell : DrawnCells)
+    {
+        const float Alpha = FMath::Clamp(Cell.Value.Heat / 10.0f, 0.0f, 1.0f);
+        const FColor Color = FLinearColor::LerpUsingHSV(FLinearColor::Blue, FLinearColor::Red, Alpha).ToFColor(true);
+        const FVector Center((Cell.Key.X + 0.5f) * CellSize, (Cell.Key.Y + 0.5f) * CellSize, Cell.Value.Z);
+
+        DrawDebugSolidBox(World, Center, FVector(CellSize * 0.45f, CellSize * 0.45f, 5.0f), Color.WithAlpha(128));
+    }
+}
+
+#endif // ENABLE_DRAW_DEBUG
@@ -0,0 +1,287 @@
+#include "DigShotSubsystem.h"
+#include "GAM415Project.h"
+#include "DigProjectile.h"
+#include "ProceduralTerrain.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "TimerManager.h"
+
+bool UDigShotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UDigShotSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UDigShotSubsystem, STATGROUP_Tickables);
+}
+
+void UDigShotSubsystem::FireShot(const FDigShot& Shot)
+{
+    FireShots(MakeArrayView(&Shot, 1));
+}
+
+void UDigShotSubsystem::FireDigShot(const FVector& Start, const FVector& Direction, float DigRadius,
+                                    float DigStrength, float MaxDistance, AActor* IgnoredActor)
+{
+    FDigShot Shot;
+    Shot.Start = Start;
+    Shot.Direction = Direction.GetSafeNormal();
+    Shot.DigRadius = DigRadius;
+    Shot.DigStrength = DigStrength;
+    Shot.MaxDistance = MaxDistance;
+    Shot.IgnoredActor = IgnoredActor;
+    FireShot(Shot);
+}
+
+// Performs a line trace per shot to detect collisions and modify terrain if applicable.
+void UDigShotSubsystem::FireShots(TConstArrayView<FDigShot> Shots)
+{
+    TArray<AProceduralTerrain*> BatchedTerrains;
+
+    for (const FDigShot& Shot : Shots)
+    {
+        FHitResult HitResult;
+        const bool bBlockingHitIsFound = TraceShot(Shot, HitResult);
+        ApplyShotHit(Shot, bBlockingHitIsFound ? &HitResult : nullptr, BatchedTerrains);
+    }
+
+    EndTerrainBatches(BatchedTerrains);
+    NumShotsFired += Shots.Num();
+}
+
+void UDigShotSubsystem::QueueShot(const FDigShot& Shot)
+{
+    QueueShots(MakeArrayView(&Shot, 1));
+}
+
+// Issues the traces without waiting; the async trace system runs them in parallel with the frame.
+void UDigShotSubsystem::QueueShots(TConstArrayView<FDigShot> Shots)
+{
+    UWorld* World = GetWorld();
+    PendingShots.Reserve(PendingShots.Num() + Shots.Num());
+
+    for (const FDigShot& Shot : Shots)
+    {
+        FPendingShot& Pending = PendingShots.AddDefaulted_GetRef();
+        Pending.Shot = Shot;
+        const FVector EndLocation = Shot.Start + Shot.Direction * Shot.MaxDistance;
+
+        if (Shot.Type == EDigShotType::Sweep)
+        {
+            Pending.TraceHandle = World->AsyncSweepByChannel(EAsyncTraceType::Single, Shot.Start, EndLocation, FQuat::Identity,
+                                                             ECC_WorldStatic, FCollisionShape::MakeSphere(Shot.DigRadius),
+                                                             MakeQueryParams(Shot));
+        }
+        else
+        {
+            Pending.TraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Shot.Start, EndLocation,
+                                                                 ECC_WorldStatic, MakeQueryParams(Shot));
+        }
+    }
+}
+
+// Applies every queued shot whose trace finished last frame, batching the terrain updates.
+void UDigShotSubsystem::Tick(float DeltaTime)
+{
+#if ENABLE_DRAW_DEBUG
+    DebugDraw.Tick(GetWorld(), DeltaTime);
+#endif
+
+    if (PendingShots.IsEmpty()) return;
+
+    const double StartTime = FPlatformTime::Seconds();
+    UWorld* World = GetWorld();
+
+    int32 NumKept = 0;
+    int32 NumDropped = 0;
+    for (int32 i = 0; i < PendingShots.Num(); i++)
+    {
+        FPendingShot& Pending = PendingShots[i];
+
+        FTraceDatum TraceData;
+        if (World->QueryTraceData(Pending.TraceHandle, TraceData))
+        {
+            const FHitResult* Hit = TraceData.OutHits.Num() > 0 && TraceData.OutHits[0].bBlockingHit ? &TraceData.OutHits[0] : nullptr;
+            ApplyShotHit(Pending.Shot, Hit, TickBatchedTerrains);
+            NumShotsFired++;
+        }
+        else if (World->IsTraceHandleValid(Pending.TraceHandle, false /* bOverlapTrace */))
+        {
+            // No data yet, but the handle still belongs to a frame whose traces are running:
+            // queued this frame, so its results arrive next tick.
+            if (NumKept != i)
+            {
+                PendingShots[NumKept] = MoveTemp(Pending);
+            }
+            NumKept++;
+        }
+        else
+        {
+            // The trace buffer the handle pointed into has been recycled, so the result is lost.
+            NumDropped++;
+        }
+    }
+    PendingShots.SetNum(NumKept, EAllowShrinking::No);
+
+    if (NumDropped > 0)
+    {
+        NumShotsDropped += NumDropped;
+        UE_LOG(LogGAM415Project, Warning, TEXT("Dropped %d queued dig shots whose async traces expired (%lld total)"),
+               NumDropped, NumShotsDropped);
+    }
+
+    EndTerrainBatches(TickBatchedTerrains);
+    ResolveSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void UDigShotSubsystem::ApplyShotHit(const FDigShot& Shot, const FHitResult* Hit, TArray<AProceduralTerrain*>& BatchedTerrains)
+{
+    // Check if the hit actor is of type AProceduralTerrain.
+    AProceduralTerrain* Terrain = Hit ? Cast<AProceduralTerrain>(Hit->GetActor()) : nullptr;
+    if (Terrain)
+    {
+        if (!BatchedTerrains.Contains(Terrain))
+        {
+            Terrain->BeginModificationBatch();
+            BatchedTerrains.Add(Terrain);
+        }
+
+        if (Shot.Type == EDigShotType::Line)
+        {
+            // Modify the terrain at the hit location using specified radius and strength.
+            Terrain->ModifyTerrainAtLocation(Hit->Location, Shot.DigRadius, Shot.DigStrength);
+        }
+        else
+        {
+            // Carve the whole trench or tunnel as one stroke. Tunnels keep going along the shot; trenches
+            // follow the surface, so the shot is flattened onto the hit's plane. A shot straight into the
+            // surface has no direction along it and leaves a crater. For sweeps, Location is the sphere's
+            // center at contact.
+            const FVector StrokeDirection = Shot.Type == EDigShotType::Sweep
+                ? FVector::VectorPlaneProject(Shot.Direction, Hit->ImpactNormal).GetSafeNormal()
+                : Shot.Direction;
+            Terrain->ModifyTerrainAlongSegment(Hit->Location, Hit->Location + StrokeDirection * Shot.StrokeLength,
+                                               Shot.DigRadius, Shot.DigStrength);
+        }
+    }
+
+#if ENABLE_DRAW_DEBUG
+    DebugDraw.AddShot(GetWorld(), Shot, Hit, Terrain != nullptr);
+#endif
+}
+
+void UDigShotSubsystem::EndTerrainBatches(TArray<AProceduralTerrain*>& BatchedTerrains)
+{
+    for (AProceduralTerrain* Terrain : BatchedTerrains)
+    {
+        Terrain->EndModificationBatch();
+    }
+    BatchedTerrains.Reset();
+}
+
+bool UDigShotSubsystem::TraceShot(const FDigShot& Shot, FHitResult& OutHit) const
+{
+    // Calculate the end point of the trace based on the maximum distance.
+    const FVector EndLocation = Shot.Start + Shot.Direction * Shot.MaxDistance;
+
+    // Trace along the specified channel (static world objects).
+    if (Shot.Type == EDigShotType::Sweep)
+    {
+        return GetWorld()->SweepSingleByChannel(OutHit, Shot.Start, EndLocation, FQuat::Identity, ECC_WorldStatic,
+                                                FCollisionShape::MakeSphere(Shot.DigRadius), MakeQueryParams(Shot));
+    }
+    return GetWorld()->LineTraceSingleByChannel(OutHit, Shot.Start, EndLocation, ECC_WorldStatic, MakeQueryParams(Shot));
+}
+
+FCollisionQueryParams UDigShotSubsystem::MakeQueryParams(const FDigShot& Shot)
+{
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DigShot));
+    // Ensure the trace ignores the shooter.
+    QueryParams.AddIgnoredActor(Shot.IgnoredActor.Get());
+    return QueryParams;
+}
+
+/// | Benchmark | ///
+
+// Fires the same shots from the first player's view three ways and logs the game thread cost of each:
+// spawning an ADigProjectile per shot, synchronous subsystem shots, and queued async shots
+// (issue cost now, resolve cost once the next tick has applied them).
+// Usage: Dig.BenchmarkShots [Count=500] [DigStrength=0]
+static void RunDigShotBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    UDigShotSubsystem* Subsystem = World ? World->GetSubsystem<UDigShotSubsystem>() : nullptr;
+    APlayerController* PlayerController = World ? UGameplayStatics::GetPlayerController(World, 0) : nullptr;
+    if (!Subsystem || !PlayerController)
+    {
+        UE_LOG(LogGAM415Project, Warning, TEXT("Dig.BenchmarkShots needs a game world with a player"));
+        return;
+    }
+
+    const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+    const float DigStrength = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 0.0f;
+
+    FVector ViewLocation;
+    FRotator ViewRotation;
+    PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+    FDigShot Shot;
+    Shot.Start = ViewLocation;
+    Shot.Direction = ViewRotation.Vector();
+    Shot.DigStrength = DigStrength;
+    Shot.IgnoredActor = PlayerController->GetPawn();
+
+    // Spawn and destroy an actor per shot, the way weapons used to fire.
+    const FTransform SpawnTransform(ViewRotation, ViewLocation);
+    double StartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Count; i++)
+    {
+        ADigProjectile* Projectile = World->SpawnActorDeferred<ADigProjectile>(ADigProjectile::StaticClass(), SpawnTransform);
+        Projectile->DigStrength = DigStrength;
+        Projectile->FinishSpawning(SpawnTransform);
+    }
+    const double SpawnSeconds = FMath::Max(FPlatformTime::Seconds() - StartTime, 1e-6);
+
+    // Fire the same shots as records with synchronous traces.
+    StartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < Count; i++)
+    {
+        Subsystem->FireShot(Shot);
+    }
+    const double PooledSeconds = FMath::Max(FPlatformTime::Seconds() - StartTime, 1e-6);
+
+    // Queue them on the async trace system.
+    TArray<FDigShot> Shots;
+    Shots.Init(Shot, Count);
+    const double ResolveSecondsBefore = Subsystem->GetResolveSeconds();
+    StartTime = FPlatformTime::Seconds();
+    Subsystem->QueueShots(Shots);
+    const double QueueSeconds = FPlatformTime::Seconds() - StartTime;
+
+    UE_LOG(LogGAM415Project, Display,
+           TEXT("Dig shot benchmark, %d shots: spawn-per-shot %.1f ms (%.0f shots/s), pooled %.1f ms (%.0f shots/s), x%.2f"),
+           Count, SpawnSeconds * 1000.0, Count / SpawnSeconds, PooledSeconds * 1000.0, Count / PooledSeconds,
+           SpawnSeconds / PooledSeconds);
+
+    // Queued shots resolve on the next subsystem tick; report once two frames have passed.
+    TWeakObjectPtr<UDigShotSubsystem> WeakSubsystem = Subsystem;
+    TWeakObjectPtr<UWorld> WeakWorld = World;
+    World->GetTimerManager().SetTimerForNextTick([=]()
+    {
+        if (!WeakWorld.IsValid()) return;
+        WeakWorld->GetTimerManager().SetTimerForNextTick([=]()
+        {
+            if (!WeakSubsystem.IsValid()) return;
+            const double AsyncSeconds = FMath::Max(QueueSeconds + WeakSubsystem->GetResolveSeconds() - ResolveSecondsBefore, 1e-6);
+            UE_LOG(LogGAM415Project, Display,
+                   TEXT("Dig shot benchmark, %d shots: async game thread %.1f ms (%.1f ms issue) (%.0f shots/s), x%.2f vs pooled, %d still pending"),
+                   Count, AsyncSeconds * 1000.0, QueueSeconds * 1000.0, Count / AsyncSeconds, PooledSeconds / AsyncSeconds,
+                   WeakSubsystem->GetNumPendingShots());
+        });
+    });
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GDigShotBenchmarkCommand(
+    TEXT("Dig.BenchmarkShots"),
+    TEXT("Fires dig shots from the player's view via spawned ADigProjectile actors, synchronous subsystem shots and queued async shots, and logs game thread shots/second for each. Args: [Count=500] [DigStrength=0]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunDigShotBenchmark));
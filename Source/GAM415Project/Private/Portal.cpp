@@ -4,12 +4,28 @@
 #include "Engine/TextureRenderTarget2D.h"
 #include "Components/SceneCaptureComponent2D.h"
 #include "Components/StaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/LocalPlayer.h"
+#include "EngineUtils.h"
+#include "GAM415Project.h"
+#include "PortalSubsystem.h"
+#include "SceneView.h"
 #include "GameFramework/Pawn.h"
-#include "GameFramework/PawnMovementComponent.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Controller.h"
+
+DECLARE_STATS_GROUP(TEXT("Portals"), STATGROUP_Portals, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Captures"), STAT_PortalCaptures, STATGROUP_Portals);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skipped (Distance)"), STAT_PortalSkippedDistance, STATGROUP_Portals);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skipped (Back Facing)"), STAT_PortalSkippedBackFacing, STATGROUP_Portals);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skipped (Not Rendered)"), STAT_PortalSkippedNotRendered, STATGROUP_Portals);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Skipped (Frustum)"), STAT_PortalSkippedFrustum, STATGROUP_Portals);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred (Budget)"), STAT_PortalDeferred, STATGROUP_Portals);
 
 APortal::APortal()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // UPortalSubsystem decides when portals capture, so they never tick on their own
+    PrimaryActorTick.bCanEverTick = false;
 
     // Root component for hierarchy organization
     RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
@@ -18,11 +34,19 @@ APortal::APortal()
     PortalMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("PortalMesh"));
     PortalMesh->SetupAttachment(RootComponent);
     PortalMesh->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+    PortalMesh->SetCollisionResponseToChannel(ECC_GameTraceChannel1, ECR_Overlap); // Projectiles pass through instead of splatting
     PortalMesh->CastShadow = false;
 
     // Scene capture setup
     SceneCapture = CreateDefaultSubobject<USceneCaptureComponent2D>(TEXT("SceneCapture"));
     SceneCapture->SetupAttachment(RootComponent);
+
+    // Captures are issued manually, only while the portal can be seen
+    SceneCapture->bCaptureEveryFrame = false;
+    SceneCapture->bCaptureOnMovement = false;
+
+    // Render target scale steps, from a quarter to full viewport resolution
+    RenderTargetScaleSteps = { 0.25f, 0.375f, 0.5f, 0.75f, 1.0f };
 }
 
 void APortal::BeginPlay()
@@ -32,18 +56,207 @@ void APortal::BeginPlay()
     InitializePortalMaterial();
     PortalMesh->OnComponentBeginOverlap.AddDynamic(this, &APortal::OnOverlapBegin);
     InitializeSceneCapture();
+
+    if (UPortalSubsystem* Portals = GetWorld()->GetSubsystem<UPortalSubsystem>())
+        Portals->RegisterPortal(this);
+}
+
+/// | Portal Registration | ///
+
+void APortal::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    for (FPortalViewCapture& ViewCapture : ViewCaptures)
+        ReleaseRenderTarget(ViewCapture);
+
+    if (UPortalSubsystem* Portals = GetWorld()->GetSubsystem<UPortalSubsystem>())
+        Portals->UnregisterPortal(this);
+
+    Super::EndPlay(EndPlayReason);
 }
 
-// Frame update: Maintains portal view rendering
-void APortal::Tick(float DeltaTime)
+/// | Capture Culling | ///
+
+// Reads the camera and, when the player has a viewport, its projection
+bool APortal::GetPlayerView(const APlayerController* PlayerController, FPortalView& OutView)
 {
-    Super::Tick(DeltaTime);
+    if (!PlayerController || !PlayerController->PlayerCameraManager) return false;
 
-    if (LinkedPortal.IsValid())
+    const APlayerCameraManager* Camera = PlayerController->PlayerCameraManager;
+    OutView.PlayerController = const_cast<APlayerController*>(PlayerController);
+    OutView.ViewIndex = 0;
+    OutView.Location = Camera->GetCameraLocation();
+    OutView.Rotation = Camera->GetCameraRotation();
+    OutView.FOV = Camera->GetFOVAngle();
+    OutView.ViewSize = GetViewportSize();
+    OutView.bHasFrustum = false;
+
+    // The constrained view rect is the player's split-screen share of the viewport
+    const ULocalPlayer* LocalPlayer = PlayerController->GetLocalPlayer();
+    if (LocalPlayer)
+        OutView.ViewIndex = FMath::Max(LocalPlayer->GetLocalPlayerIndex(), 0);
+
+    FSceneViewProjectionData ProjectionData;
+    if (LocalPlayer && LocalPlayer->ViewportClient &&
+        LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
     {
-        UpdateRenderTargetSize();
-        UpdateSceneCapture();
+        OutView.ViewSize = FVector2D(ProjectionData.GetConstrainedViewRect().Size());
+        GetViewFrustumBounds(OutView.Frustum, ProjectionData.ComputeViewProjectionMatrix(), false);
+        OutView.bHasFrustum = true;
     }
+    return true;
+}
+
+EPortalVisibility APortal::GetVisibility(const FPortalView& View, bool bCheckRendered) const
+{
+    const FVector ToCamera = View.Location - GetActorLocation();
+
+    if (MaxCaptureDistance > 0.0f && ToCamera.SizeSquared() > FMath::Square(MaxCaptureDistance))
+        return EPortalVisibility::TooFar;
+
+    if (FVector::DotProduct(ToCamera, GetFrontNormal()) < 0.0f)
+        return EPortalVisibility::BackFacing;
+
+    // Occluded or culled by the renderer last frame. Each player has its own surface once captured
+    // for, so this only tells about the view's player.
+    const UStaticMeshComponent* Surface = PortalMesh;
+    if (ViewCaptures.IsValidIndex(View.ViewIndex) && ViewCaptures[View.ViewIndex].Surface)
+        Surface = ViewCaptures[View.ViewIndex].Surface;
+
+    if (bCheckRendered && !Surface->WasRecentlyRendered(RecentlyRenderedTolerance))
+        return EPortalVisibility::NotRendered;
+
+    if (View.bHasFrustum && !View.Frustum.IntersectBox(PortalMesh->Bounds.Origin, PortalMesh->Bounds.BoxExtent))
+        return EPortalVisibility::OutsideFrustum;
+
+    return EPortalVisibility::Visible;
+}
+
+// Renders the linked portal's view as seen from the player, including this portal's own surface
+// seen through itself down to the recursion depth
+int32 APortal::CaptureView(const FPortalView& View, int32 MaxRecursiveCaptures)
+{
+    FPortalViewCapture& ViewCapture = FindOrAddViewCapture(View);
+    USceneCaptureComponent2D* Capture = ViewCapture.SceneCapture;
+
+    // Later players' surface copies are hidden from every scene capture, so recursive levels show
+    // the deeper image on PortalMesh and hand it back to the first player once done
+    UMaterialInstanceDynamic* Material = PortalMaterialInstance;
+
+    // Hysteresis runs on the time since the last capture, as portals off budget capture less often
+    const double Now = GetWorld()->GetTimeSeconds();
+    const float SinceLastCapture = ViewCapture.LastCaptureTime >= 0.0 ? float(Now - ViewCapture.LastCaptureTime) : 0.0f;
+
+    UpdateRenderTargetSize(ViewCapture, View, SinceLastCapture);
+    UTextureRenderTarget2D* MainTarget = Capture->TextureTarget;
+    UPortalSubsystem* Portals = GetWorld()->GetSubsystem<UPortalSubsystem>();
+
+    // Virtual player cameras per level: level N looks through the portal N times
+    TArray<FVector, TInlineAllocator<8>> CameraLocations = { View.Location };
+    TArray<FRotator, TInlineAllocator<8>> CameraRotations = { View.Rotation };
+
+    // Go deeper while this portal shows up in the previous level's capture and its recursive image
+    // still covers enough of the screen to be worth rendering
+    const int32 MaxLevels = FMath::Min(MaxRecursionDepth, MaxRecursiveCaptures + 1);
+    float Footprint = GetScreenCoverage(View);
+    while (MainTarget && Portals && CameraLocations.Num() < MaxLevels)
+    {
+        FVector Location = CameraLocations.Last();
+        FRotator Rotation = CameraRotations.Last();
+        TransformViewThroughPortal(Location, Rotation);
+
+        Footprint *= GetCoverageFromCamera(PortalMesh->Bounds.GetBox(), Location, Rotation, View.FOV, View.ViewSize);
+        if (Footprint < MinRecursionFootprint) break;
+
+        CameraLocations.Add(Location);
+        CameraRotations.Add(Rotation);
+    }
+
+    // Render the deepest level first; each level's capture shows the level below on this portal's
+    // surface. Deeper levels ping-pong between two pooled targets at falling resolutions.
+    const int32 NumLevels = CameraLocations.Num();
+    UTextureRenderTarget2D* DeeperTarget = nullptr;
+    for (int32 Level = NumLevels - 1; Level >= 0; Level--)
+    {
+        UTextureRenderTarget2D* LevelTarget = MainTarget;
+        if (Level > 0)
+        {
+            const float LevelScale = FMath::Pow(RecursionResolutionScale, float(Level));
+            const FIntPoint LevelSize(FMath::Max(FMath::RoundToInt32(MainTarget->SizeX * LevelScale), 16),
+                                      FMath::Max(FMath::RoundToInt32(MainTarget->SizeY * LevelScale), 16));
+            LevelTarget = Portals->AcquireRenderTarget(LevelSize, RenderTargetFormat);
+        }
+
+        // The deepest level has nothing to show on this portal, so hide it as before
+        if (DeeperTarget)
+        {
+            Capture->HiddenActors.Remove(this);
+            if (Material)
+                Material->SetTextureParameterValue("RenderTexture", DeeperTarget);
+        }
+        else
+        {
+            Capture->HiddenActors.AddUnique(this);
+        }
+
+        Capture->TextureTarget = LevelTarget;
+        UpdateSceneCaptureTransform(Capture, CameraLocations[Level], CameraRotations[Level], View.FOV);
+        Capture->CaptureScene();
+        INC_DWORD_STAT(STAT_PortalCaptures);
+
+        if (DeeperTarget)
+            Portals->ReleaseRenderTarget(DeeperTarget);
+        DeeperTarget = LevelTarget != MainTarget ? LevelTarget : nullptr;
+    }
+
+    // Back to showing the top level
+    Capture->TextureTarget = MainTarget;
+    Capture->HiddenActors.AddUnique(this);
+    if (Material && NumLevels > 1)
+    {
+        const USceneCaptureComponent2D* FirstCapture = ViewCaptures[0].SceneCapture;
+        Material->SetTextureParameterValue("RenderTexture", FirstCapture ? FirstCapture->TextureTarget : nullptr);
+    }
+
+    NumCaptures++;
+    ViewCapture.LastCaptureFrame = GFrameCounter;
+    ViewCapture.LastCaptureTime = Now;
+    ViewCapture.LastVisibleTime = Now;
+    return NumLevels - 1;
+}
+
+// Counts a capture skipped because the portal could not be seen; the last capture stays in place
+void APortal::RecordSkippedCapture(const FPortalView& View, EPortalVisibility Reason)
+{
+    switch (Reason)
+    {
+    case EPortalVisibility::TooFar:         INC_DWORD_STAT(STAT_PortalSkippedDistance); break;
+    case EPortalVisibility::BackFacing:     INC_DWORD_STAT(STAT_PortalSkippedBackFacing); break;
+    case EPortalVisibility::NotRendered:    INC_DWORD_STAT(STAT_PortalSkippedNotRendered); break;
+    case EPortalVisibility::OutsideFrustum: INC_DWORD_STAT(STAT_PortalSkippedFrustum); break;
+    default: return;
+    }
+    NumSkippedCaptures++;
+    NumSkippedByReason[uint8(Reason)]++;
+
+    // Hand the render target to visible portals once this one has stayed hidden for a while
+    if (!ViewCaptures.IsValidIndex(View.ViewIndex)) return;
+
+    FPortalViewCapture& ViewCapture = ViewCaptures[View.ViewIndex];
+    if (GetWorld()->GetTimeSeconds() - ViewCapture.LastVisibleTime >= RenderTargetReleaseDelay)
+        ReleaseRenderTarget(ViewCapture);
+}
+
+// Counts a visible portal left for a later frame by the capture budget
+void APortal::RecordDeferredCapture(const FPortalView& View)
+{
+    INC_DWORD_STAT(STAT_PortalDeferred);
+    NumDeferredCaptures++;
+    FindOrAddViewCapture(View).LastVisibleTime = GetWorld()->GetTimeSeconds();
+}
+
+uint64 APortal::GetLastCaptureFrame(const FPortalView& View) const
+{
+    return ViewCaptures.IsValidIndex(View.ViewIndex) ? ViewCaptures[View.ViewIndex].LastCaptureFrame : 0;
 }
 
 /// | Teleportation System Implementation | ///
@@ -53,78 +266,141 @@ void APortal::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* O
                              UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, 
                              bool bFromSweep, const FHitResult& SweepResult)
 {
-    if (!LinkedPortal.IsValid()
-     || !OtherActor->IsA(APawn::StaticClass())
-     || IgnoredActors.Contains(OtherActor))
+    if (!LinkedPortal.IsValid() || !CanTeleport(OtherActor))
         return;
 
-    APawn* Pawn = Cast<APawn>(OtherActor);
-    if (Pawn && Pawn->GetController() && IsFrontFacing(SweepResult.ImpactNormal))
-        HandleTeleportation(Pawn);
+    // Physics bodies overlap without a sweep, so their direction comes from their velocity
+    const FVector Velocity = GetTeleportVelocity(OtherActor);
+    if (bFromSweep ? IsFrontFacing(SweepResult.ImpactNormal) : IsMovingIntoFront(Velocity))
+        HandleTeleportation(OtherActor, Velocity);
+}
+
+// Attached actors travel with their parent, and other portals never move through
+bool APortal::CanTeleport(const AActor* Actor) const
+{
+    if (!Actor || Actor->IsA<APortal>() || !Actor->IsRootComponentMovable() || Actor->GetAttachParentActor())
+        return false;
+
+    const double* CooldownEnd = TeleportCooldowns.Find(FObjectKey(Actor));
+    return !CooldownEnd || GetWorld()->GetTimeSeconds() >= *CooldownEnd;
 }
 
 // Determines if impact occurred on front-facing side of portal
 bool APortal::IsFrontFacing(const FVector& ImpactNormal) const
 {
     // Threshold for front-facing detection (70% alignment)
-    return FVector::DotProduct(ImpactNormal, GetActorForwardVector()) > 0.7f;
+    return FVector::DotProduct(ImpactNormal, GetFrontNormal()) > 0.7f;
+}
+
+// Moving against the front normal, as a sweep hitting the front would report
+bool APortal::IsMovingIntoFront(const FVector& Velocity) const
+{
+    return FVector::DotProduct(Velocity, GetFrontNormal()) < 0.0f;
+}
+
+// The sphere touches the front once its center comes within Radius of the portal plane. The
+// crossing point is tested against the surface's bounds on the plane through their center.
+bool APortal::FindEntry(const FVector& Start, const FVector& End, float Radius, float& OutTime) const
+{
+    const FVector Front = GetFrontNormal();
+    const double StartDistance = FVector::DotProduct(Start - GetActorLocation(), Front) - Radius;
+    const double EndDistance = FVector::DotProduct(End - GetActorLocation(), Front) - Radius;
+    if (StartDistance < 0.0 || EndDistance > 0.0 || StartDistance == EndDistance)
+        return false;
+
+    const double Time = StartDistance / (StartDistance - EndDistance);
+    const FVector Entry = FMath::Lerp(Start, End, Time);
+    const FVector OnSurface = Entry - Front * FVector::DotProduct(Entry - PortalMesh->Bounds.Origin, Front);
+    if (!PortalMesh->Bounds.GetBox().ExpandBy(1.0).IsInside(OnSurface))
+        return false;
+
+    OutTime = float(Time);
+    return true;
+}
+
+void APortal::TransformThroughPortal(FVector& Location, FVector& Velocity) const
+{
+    if (!LinkedPortal.IsValid()) return;
+
+    Location = TransformPositionBetweenPortals(GetActorTransform(), LinkedPortal->GetActorTransform(), Location);
+    Velocity = CalculateTeleportVelocity(Velocity);
 }
 
 // Main teleportation sequence controller
-void APortal::HandleTeleportation(APawn* Pawn)
+void APortal::HandleTeleportation(AActor* Actor, const FVector& Velocity)
 {
     if (!LinkedPortal.IsValid()) return;
 
-    // Add to teleport cooldown list
-    IgnoredActors.Add(Pawn);
-    LinkedPortal->IgnoredActors.Add(Pawn);
-    
-    // Cooldown timer setup
-    FTimerDelegate TimerDelegate;
-    TimerDelegate.BindLambda([this, Pawn]()
-    {
-        IgnoredActors.Remove(Pawn);
-        if (LinkedPortal.IsValid())
-            LinkedPortal->IgnoredActors.Remove(Pawn);
-    });
-    GetWorld()->GetTimerManager().SetTimer(IgnoreTimerHandle, TimerDelegate, 0.2f, false);
+    // Both portals ignore the actor until the cooldown ends; each actor has its own entry, so
+    // actors passing through together never cut each other's cooldown short
+    const double CooldownEnd = GetWorld()->GetTimeSeconds() + TeleportCooldown;
+    StartTeleportCooldown(Actor, CooldownEnd);
+    LinkedPortal->StartTeleportCooldown(Actor, CooldownEnd);
 
     // Calculate transformed properties
-    const FVector NewLocation = CalculateTeleportLocation(Pawn);
-    const FRotator NewRotation = CalculateTeleportRotation(Pawn);
-    const FRotator NewControlRotation = CalculateControllerRotation(Pawn->GetController());
-    const FVector NewVelocity = CalculateTeleportVelocity(GetTeleportVelocity(Pawn));
+    const FVector NewLocation = CalculateTeleportLocation(Actor);
+    const FRotator NewRotation = CalculateTeleportRotation(Actor);
+    const FVector NewVelocity = CalculateTeleportVelocity(Velocity);
+
+    const APawn* Pawn = Cast<APawn>(Actor);
+    AController* Controller = Pawn ? Pawn->GetController() : nullptr;
+    const FRotator NewControlRotation = Controller ? CalculateControllerRotation(Controller) : FRotator::ZeroRotator;
 
     // Execute teleportation
-    Pawn->TeleportTo(NewLocation, NewRotation);
+    if (!Actor->TeleportTo(NewLocation, NewRotation)) return;
 
     // Update controller orientation
-    if (AController* Controller = Pawn->GetController())
+    if (Controller)
         Controller->SetControlRotation(NewControlRotation);
 
-    ApplyTeleportVelocity(Pawn, NewVelocity);
+    ApplyTeleportVelocity(Actor, NewVelocity);
 }
 
-// Retrieves current velocity from appropriate component
-FVector APortal::GetTeleportVelocity(const APawn* Pawn) const
+// Expired entries are removed whenever the map has doubled since the last sweep, so busy portals
+// stay O(1) per overlap on average without a timer per actor
+void APortal::StartTeleportCooldown(const AActor* Actor, double EndTime)
 {
-    if (const UPawnMovementComponent* Movement = Pawn->GetMovementComponent())
-        return Movement->Velocity;
+    if (TeleportCooldowns.Num() >= NextCooldownPrune)
+    {
+        const double Now = GetWorld()->GetTimeSeconds();
+        for (auto It = TeleportCooldowns.CreateIterator(); It; ++It)
+            if (It.Value() <= Now) It.RemoveCurrent();
+
+        NextCooldownPrune = FMath::Max(TeleportCooldowns.Num() * 2, 16);
+    }
+
+    TeleportCooldowns.Add(FObjectKey(Actor), EndTime);
+}
 
-    if (UPrimitiveComponent* Physics = Cast<UPrimitiveComponent>(Pawn->GetRootComponent()))
-        return Physics->IsSimulatingPhysics() ? Physics->GetPhysicsLinearVelocity() : FVector::ZeroVector;
+// Retrieves current velocity from physics, or from a movement component such as a character's
+// or a projectile's
+FVector APortal::GetTeleportVelocity(const AActor* Actor)
+{
+    const UPrimitiveComponent* Physics = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+    if (Physics && Physics->IsSimulatingPhysics())
+        return Physics->GetPhysicsLinearVelocity();
+
+    if (const UMovementComponent* Movement = Actor->FindComponentByClass<UMovementComponent>())
+        return Movement->Velocity;
 
-    return FVector::ZeroVector;
+    return Actor->GetVelocity();
 }
 
-// Applies transformed velocity to target component
-void APortal::ApplyTeleportVelocity(APawn* Pawn, const FVector& NewVelocity) const
+// Applies transformed velocity to target component. The teleport keeps a physics body's world
+// space spin, so that is turned through the portal as well.
+void APortal::ApplyTeleportVelocity(AActor* Actor, const FVector& NewVelocity) const
 {
-    if (UPawnMovementComponent* Movement = Pawn->GetMovementComponent())
+    UPrimitiveComponent* Physics = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+    if (Physics && Physics->IsSimulatingPhysics())
+    {
+        Physics->SetPhysicsLinearVelocity(NewVelocity);
+        Physics->SetPhysicsAngularVelocityInDegrees(CalculateTeleportVelocity(Physics->GetPhysicsAngularVelocityInDegrees()));
+    }
+    else if (UMovementComponent* Movement = Actor->FindComponentByClass<UMovementComponent>())
+    {
         Movement->Velocity = NewVelocity;
-    else if (UPrimitiveComponent* Physics = Cast<UPrimitiveComponent>(Pawn->GetRootComponent()))
-        if (Physics->IsSimulatingPhysics()) 
-            Physics->SetPhysicsLinearVelocity(NewVelocity);
+        Movement->UpdateComponentVelocity();
+    }
 }
 
 /// | Spatial Transformation Calculations | ///
@@ -198,87 +474,334 @@ void APortal::InitializeSceneCapture()
 {
     if (!SceneCapture || !LinkedPortal.IsValid()) return;
 
-    // Create dynamic render target
-    SceneCapture->TextureTarget = NewObject<UTextureRenderTarget2D>();
-    UpdateRenderTargetSize();
-    ConfigureClipPlane();
+    // Render targets are borrowed from UPortalSubsystem's pool on each view's first capture
 
-    // Apply render texture to portal material
-    if (PortalMaterialInstance)
-        PortalMaterialInstance->SetTextureParameterValue("RenderTexture", SceneCapture->TextureTarget);
+    // Clipping at the linked portal is done by an oblique projection, not the global clip plane
+    SceneCapture->bEnableClipPlane = false;
+    SceneCapture->bUseCustomProjectionMatrix = bShouldClipPlane;
 
     // Hide portal actors from own capture
-    SceneCapture->HiddenActors.Add(this);
-    SceneCapture->HiddenActors.Add(LinkedPortal.Get());
+    SceneCapture->HiddenActors.AddUnique(this);
+    SceneCapture->HiddenActors.AddUnique(LinkedPortal.Get());
+
+    // Captures of later players are copies of this one
+    for (FPortalViewCapture& ViewCapture : ViewCaptures)
+    {
+        if (!ViewCapture.SceneCapture || ViewCapture.SceneCapture == SceneCapture) continue;
+
+        ViewCapture.SceneCapture->bEnableClipPlane = false;
+        ViewCapture.SceneCapture->bUseCustomProjectionMatrix = bShouldClipPlane;
+        ViewCapture.SceneCapture->HiddenActors = SceneCapture->HiddenActors;
+    }
 }
 
-// Adjusts render target resolution to match viewport
-void APortal::UpdateRenderTargetSize()
+// The first player uses the portal's own surface and capture. Later players get copies of both
+// that render only for them: the copied surface has no collision, so teleporting still goes
+// through PortalMesh alone.
+FPortalViewCapture& APortal::FindOrAddViewCapture(const FPortalView& View)
 {
-    const FVector2D ViewportSize = GetViewportSize();
-    UTextureRenderTarget2D* Target = SceneCapture->TextureTarget;
+    const int32 ViewIndex = FMath::Max(View.ViewIndex, 0);
+    if (ViewCaptures.Num() <= ViewIndex)
+        ViewCaptures.SetNum(ViewIndex + 1);
 
-    if (Target && (Target->SizeX != ViewportSize.X || Target->SizeY != ViewportSize.Y))
+    FPortalViewCapture& ViewCapture = ViewCaptures[ViewIndex];
+    if (!ViewCapture.SceneCapture)
     {
-        Target->InitAutoFormat(ViewportSize.X, ViewportSize.Y);
-        Target->UpdateResource();
+        ViewCapture.RenderTargetScale = SelectRenderTargetScale(1.0f);
+
+        if (ViewIndex == 0)
+        {
+            ViewCapture.SceneCapture = SceneCapture;
+            ViewCapture.Surface = PortalMesh;
+            ViewCapture.Material = PortalMaterialInstance;
+        }
+        else
+        {
+            ViewCapture.Surface = NewObject<UStaticMeshComponent>(this, NAME_None, RF_Transient, PortalMesh);
+            ViewCapture.Surface->SetupAttachment(PortalMesh->GetAttachParent());
+            ViewCapture.Surface->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+            ViewCapture.Surface->OnComponentBeginOverlap.Clear();
+            // Scene captures ignore the controllers' hidden components, so copies would z-fight there
+            ViewCapture.Surface->bHiddenInSceneCapture = true;
+            ViewCapture.Surface->RegisterComponent();
+
+            if (PortalMaterialInstance)
+            {
+                ViewCapture.Material = UMaterialInstanceDynamic::Create(PortalMaterialInstance->Parent, this);
+                ViewCapture.Material->CopyParameterOverrides(PortalMaterialInstance);
+                ViewCapture.Surface->SetMaterial(0, ViewCapture.Material);
+            }
+
+            ViewCapture.SceneCapture = NewObject<USceneCaptureComponent2D>(this, NAME_None, RF_Transient, SceneCapture);
+            ViewCapture.SceneCapture->TextureTarget = nullptr;
+            ViewCapture.SceneCapture->SetupAttachment(SceneCapture->GetAttachParent());
+            ViewCapture.SceneCapture->RegisterComponent();
+        }
     }
+
+    if (ViewCapture.PlayerController != View.PlayerController)
+    {
+        ViewCapture.PlayerController = View.PlayerController;
+        HideOtherViewSurfaces();
+    }
+    return ViewCapture;
 }
 
-// Configures clipping plane to prevent seeing behind portal
-void APortal::ConfigureClipPlane()
+// A material parameter is shared by every view drawing it, so players are kept apart by hiding
+// the other players' surfaces through their controllers instead. Captures also hide the copies by
+// component, as recursive levels un-hide this actor.
+void APortal::HideOtherViewSurfaces()
 {
-    if (!bShouldClipPlane) return;
+    if (ViewCaptures.Num() < 2) return;
 
-    SceneCapture->bEnableClipPlane = true;
-    SceneCapture->ClipPlaneBase = LinkedPortal->GetActorLocation();
-    SceneCapture->ClipPlaneNormal = -LinkedPortal->GetActorForwardVector();
+    for (const FPortalViewCapture& ViewCapture : ViewCaptures)
+    {
+        if (!ViewCapture.SceneCapture) continue;
+        for (int32 Index = 1; Index < ViewCaptures.Num(); Index++)
+            if (ViewCaptures[Index].Surface)
+                ViewCapture.SceneCapture->HiddenComponents.AddUnique(ViewCaptures[Index].Surface);
+    }
+
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        APlayerController* PlayerController = It->Get();
+        const ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+        if (!LocalPlayer) continue;
+
+        const int32 ViewIndex = LocalPlayer->GetLocalPlayerIndex();
+        for (int32 Index = 0; Index < ViewCaptures.Num(); Index++)
+            if (Index != ViewIndex && ViewCaptures[Index].Surface)
+                PlayerController->HiddenPrimitiveComponents.AddUnique(ViewCaptures[Index].Surface);
+    }
 }
 
-// Updates scene capture to match player perspective through portal
-void APortal::UpdateSceneCapture()
+// Scales the render target with the portal's screen size. Growing happens at once so the portal
+// never looks blurry; shrinking waits until the portal has stayed well below the current step.
+void APortal::UpdateRenderTargetSize(FPortalViewCapture& ViewCapture, const FPortalView& View, float DeltaTime)
 {
-    if (APlayerCameraManager* Camera = GetWorld()->GetFirstPlayerController()->PlayerCameraManager)
+    const float DesiredScale = SelectRenderTargetScale(GetScreenCoverage(View));
+
+    if (DesiredScale > ViewCapture.RenderTargetScale)
     {
-        UpdateSceneCaptureTransform(Camera->GetCameraLocation(),
-                                    Camera->GetCameraRotation(),
-                                    Camera->GetFOVAngle());
+        ViewCapture.RenderTargetScale = DesiredScale;
+        ViewCapture.ScaleDownTimer = 0.0f;
     }
+    else if (DesiredScale < ViewCapture.RenderTargetScale * (1.0f - ScaleDownHysteresis))
+    {
+        ViewCapture.ScaleDownTimer += DeltaTime;
+        if (ViewCapture.ScaleDownTimer >= ScaleDownDelay)
+        {
+            ViewCapture.RenderTargetScale = DesiredScale;
+            ViewCapture.ScaleDownTimer = 0.0f;
+        }
+    }
+    else
+    {
+        ViewCapture.ScaleDownTimer = 0.0f;
+    }
+
+    // Keep the view's aspect ratio, since the portal material samples it in screen space
+    const int32 SizeX = FMath::Max(FMath::RoundToInt32(View.ViewSize.X * ViewCapture.RenderTargetScale), 16);
+    const int32 SizeY = FMath::Max(FMath::RoundToInt32(View.ViewSize.Y * ViewCapture.RenderTargetScale), 16);
+    USceneCaptureComponent2D* Capture = ViewCapture.SceneCapture;
+    const UTextureRenderTarget2D* Target = Capture->TextureTarget;
+
+    // Swap to a pooled target of the new size instead of reallocating this one
+    if (!Target || Target->SizeX != SizeX || Target->SizeY != SizeY)
+    {
+        UPortalSubsystem* Portals = GetWorld()->GetSubsystem<UPortalSubsystem>();
+        if (!Portals) return;
+
+        ReleaseRenderTarget(ViewCapture);
+        Capture->TextureTarget = Portals->AcquireRenderTarget(FIntPoint(SizeX, SizeY), RenderTargetFormat);
+
+        if (ViewCapture.Material)
+            ViewCapture.Material->SetTextureParameterValue("RenderTexture", Capture->TextureTarget);
+    }
+}
+
+// Returns the render target to the pool. The view captures into a new one once it sees the portal again.
+void APortal::ReleaseRenderTarget(FPortalViewCapture& ViewCapture)
+{
+    USceneCaptureComponent2D* Capture = ViewCapture.SceneCapture;
+    if (!Capture || !Capture->TextureTarget) return;
+
+    if (UPortalSubsystem* Portals = GetWorld()->GetSubsystem<UPortalSubsystem>())
+        Portals->ReleaseRenderTarget(Capture->TextureTarget);
+
+    Capture->TextureTarget = nullptr;
+    if (ViewCapture.Material)
+        ViewCapture.Material->SetTextureParameterValue("RenderTexture", nullptr);
+
+    // Views without a target go first in the capture rotation
+    ViewCapture.LastCaptureFrame = 0;
+}
+
+// Projects the portal mesh bounds onto the player's view
+float APortal::GetScreenCoverage(const FPortalView& View) const
+{
+    const APlayerController* PlayerController = View.PlayerController.Get();
+    if (!PlayerController) return 1.0f;
+
+    const FBox Bounds = PortalMesh->Bounds.GetBox();
+    FBox2D ScreenRect(ForceInit);
+    for (int32 Corner = 0; Corner < 8; Corner++)
+    {
+        const FVector Point((Corner & 1) ? Bounds.Max.X : Bounds.Min.X,
+                            (Corner & 2) ? Bounds.Max.Y : Bounds.Min.Y,
+                            (Corner & 4) ? Bounds.Max.Z : Bounds.Min.Z);
+
+        // A corner behind the camera means the portal is close enough to fill the view
+        FVector2D ScreenPosition;
+        if (!PlayerController->ProjectWorldLocationToScreen(Point, ScreenPosition, true))
+            return 1.0f;
+
+        ScreenRect += ScreenPosition;
+    }
+
+    const FVector2D ViewportSize = View.ViewSize;
+    const FVector2D Min = FVector2D::Max(ScreenRect.Min, FVector2D::ZeroVector);
+    const FVector2D Max = FVector2D::Min(ScreenRect.Max, ViewportSize);
+    const FVector2D Size = FVector2D::Max(Max - Min, FVector2D::ZeroVector);
+
+    return FMath::Clamp(FMath::Max(Size.X / FMath::Max(ViewportSize.X, 1.0),
+                                   Size.Y / FMath::Max(ViewportSize.Y, 1.0)), 0.0, 1.0);
+}
+
+// Rounds a screen coverage up to the next scale step
+float APortal::SelectRenderTargetScale(float ScreenCoverage) const
+{
+    const float MaxScale = FMath::Max(MinRenderTargetScale, MaxRenderTargetScale);
+    const float Desired = FMath::Clamp(ScreenCoverage, MinRenderTargetScale, MaxScale);
+
+    float Scale = MaxScale;
+    for (const float Step : RenderTargetScaleSteps)
+        if (Step >= Desired && Step < Scale)
+            Scale = Step;
+
+    return FMath::Clamp(Scale, MinRenderTargetScale, MaxScale);
 }
 
 // Transforms camera perspective through portal connection
-void APortal::UpdateSceneCaptureTransform(const FVector& CameraLocation,
+void APortal::UpdateSceneCaptureTransform(USceneCaptureComponent2D* Capture,
+                                          const FVector& CameraLocation,
                                           const FRotator& CameraRotation,
                                           const float CameraFOV)
+{
+    FVector TransformedLocation = CameraLocation;
+    FRotator TransformedRotation = CameraRotation;
+    TransformViewThroughPortal(TransformedLocation, TransformedRotation);
+
+    Capture->SetWorldLocationAndRotation(TransformedLocation, TransformedRotation);
+    Capture->FOVAngle = CameraFOV;
+
+    // Start the view at the linked portal's surface so nothing between it and the capture is drawn
+    const UTextureRenderTarget2D* Target = Capture->TextureTarget;
+    if (bShouldClipPlane && Target)
+    {
+        const FPlane ClipPlane(LinkedPortal->GetActorLocation(), LinkedPortal->GetFrontNormal());
+        Capture->CustomProjectionMatrix = MakeObliqueProjection(TransformedLocation, TransformedRotation, CameraFOV,
+                                                                FIntPoint(Target->SizeX, Target->SizeY), ClipPlane);
+    }
+}
+
+// Moves a camera to where it looks out of the linked portal
+void APortal::TransformViewThroughPortal(FVector& Location, FRotator& Rotation) const
 {
     const FTransform Source = GetActorTransform();
     const FTransform Target = LinkedPortal->GetActorTransform();
 
-    // Transform camera position through portal
-    const FVector LocalCamera = Source.InverseTransformPosition(CameraLocation);
-    FVector TransformedLocation = Target.TransformPosition(FVector(-LocalCamera.X,
-                                                                   -LocalCamera.Y,
-                                                                    LocalCamera.Z));
+    const FVector LocalCamera = Source.InverseTransformPosition(Location);
+    Location = Target.TransformPosition(FVector(-LocalCamera.X, -LocalCamera.Y, LocalCamera.Z));
+    Rotation = TransformRotationBetweenPortals(Source, Target, Rotation);
+}
 
-    // Calculate an FOV-adjusted vertical offset to prevent visual glitches when viewed from afar
-    FVector2D ViewportSize = GetViewportSize();
-    const float Distance = FVector::Distance(CameraLocation, GetActorLocation());
-    const float PitchRadians = FMath::DegreesToRadians(CameraRotation.Pitch);
-    const float AspectRatio = ViewportSize.X / FMath::Max(ViewportSize.Y, 1.0f);
-    const float FOVRadians = FMath::DegreesToRadians(CameraFOV);
+// Projects a box into a perspective camera, the way GetScreenCoverage does for a player
+float APortal::GetCoverageFromCamera(const FBox& Bounds, const FVector& Location, const FRotator& Rotation,
+                                     float FOV, const FVector2D& ViewSize)
+{
+    const FMatrix ViewMatrix = FTranslationMatrix(-Location) * GetViewRotationMatrix(Rotation);
+    const FMatrix ProjectionMatrix = FReversedZPerspectiveMatrix(FMath::DegreesToRadians(FOV * 0.5f),
+                                                                 ViewSize.X, ViewSize.Y, GNearClippingPlane);
+    const FMatrix ViewProjection = ViewMatrix * ProjectionMatrix;
 
-    const float VerticalOffset = (-Distance * FMath::Tan(PitchRadians)) /
-                                 (AspectRatio * FMath::Tan(FOVRadians * 0.5f)) * 0.5f;
+    // Nothing of the box is seen if it lies wholly outside the camera's frustum, behind it included
+    FConvexVolume Frustum;
+    GetViewFrustumBounds(Frustum, ViewProjection, false);
+    if (!Frustum.IntersectBox(Bounds.GetCenter(), Bounds.GetExtent()))
+        return 0.0f;
 
-    TransformedLocation += LinkedPortal->GetActorUpVector() * VerticalOffset;
+    FBox2D ScreenRect(ForceInit);
+    int32 NumBehind = 0;
+    for (int32 Corner = 0; Corner < 8; Corner++)
+    {
+        const FVector Point((Corner & 1) ? Bounds.Max.X : Bounds.Min.X,
+                            (Corner & 2) ? Bounds.Max.Y : Bounds.Min.Y,
+                            (Corner & 4) ? Bounds.Max.Z : Bounds.Min.Z);
+
+        const FVector4 Clip = ViewProjection.TransformFVector4(FVector4(Point, 1.0));
+        if (Clip.W <= UE_SMALL_NUMBER)
+        {
+            NumBehind++;
+            continue;
+        }
+
+        ScreenRect += FVector2D(Clip.X / Clip.W, Clip.Y / Clip.W);
+    }
 
-    // Apply transformed rotation
-    const FRotator TransformedRotation = TransformRotationBetweenPortals(Source, Target, CameraRotation);
-    SceneCapture->SetWorldLocationAndRotation(TransformedLocation, TransformedRotation);
+    // A box wholly behind the camera covers nothing; one straddling the camera plane while in the
+    // frustum is close enough to fill the view
+    if (NumBehind == 8)
+        return 0.0f;
+    if (NumBehind > 0)
+        return 1.0f;
+
+    // Clip to the view, which spans -1 to 1 on both axes
+    const FVector2D Min = FVector2D::Max(ScreenRect.Min, FVector2D(-1.0));
+    const FVector2D Max = FVector2D::Min(ScreenRect.Max, FVector2D(1.0));
+    const FVector2D Size = FVector2D::Max(Max - Min, FVector2D::ZeroVector) * 0.5;
+
+    return FMath::Clamp(FMath::Max(Size.X, Size.Y), 0.0, 1.0);
+}
+
+// Swaps from Unreal's X-forward axes to the Z-forward axes projections expect
+FMatrix APortal::GetViewRotationMatrix(const FRotator& Rotation)
+{
+    return FInverseRotationMatrix(Rotation) *
+           FMatrix(FPlane(0, 0, 1, 0), FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 0, 1));
+}
+
+// Reversed-Z perspective projection whose near plane is replaced by ClipPlane (Lengyel's oblique
+// near plane): points on the plane get depth 1, points on its back side fall outside the depth range,
+// and the direction farthest along the plane normal still reaches depth 0 at infinity.
+FMatrix APortal::MakeObliqueProjection(const FVector& ViewLocation, const FRotator& ViewRotation, float FOV,
+                                       const FIntPoint& Size, const FPlane& ClipPlane)
+{
+    FMatrix Projection = FReversedZPerspectiveMatrix(FMath::DegreesToRadians(FOV * 0.5f),
+                                                     float(FMath::Max(Size.X, 1)), float(FMath::Max(Size.Y, 1)),
+                                                     GNearClippingPlane);
+
+    // Plane in view space
+    const FMatrix ViewRotationMatrix = GetViewRotationMatrix(ViewRotation);
+    const FVector Normal = ViewRotationMatrix.TransformVector(ClipPlane.GetSafeNormal());
+    const FVector Base = ViewRotationMatrix.TransformVector(ClipPlane.GetSafeNormal() * ClipPlane.W - ViewLocation);
+    const FVector4 C(Normal, -FVector::DotProduct(Normal, Base));
+
+    // The camera must be on the clipped side, looking toward the kept side
+    const double Denominator = FMath::Abs(C.X) / Projection.M[0][0] + FMath::Abs(C.Y) / Projection.M[1][1] + C.Z;
+    if (C.W >= -UE_KINDA_SMALL_NUMBER || Denominator <= UE_KINDA_SMALL_NUMBER)
+        return Projection;
+
+    // Depth becomes W - Scale * (C . P), so C . P = 0 lands on the near plane
+    const double Scale = 1.0 / Denominator;
+    for (int32 Row = 0; Row < 4; Row++)
+        Projection.M[Row][2] = Projection.M[Row][3] - Scale * C[Row];
+
+    return Projection;
 }
 
 // Gets current viewport resolution
-FVector2D APortal::GetViewportSize() const
+FVector2D APortal::GetViewportSize()
 {
     FVector2D Size(1920, 1080);
     if (GEngine && GEngine->GameViewport) GEngine->GameViewport->GetViewportSize(Size);
@@ -304,4 +827,228 @@ void APortal::SetLinkedPortal(APortal* NewPortal)
         NewPortal->SetLinkedPortal(this);
         InitializeSceneCapture();
     }
-}
\ No newline at end of file
+}
+
+/// | Debugging | ///
+
+// Logs how often each portal captured, skipped or waited for budget, e.g. from a -nullrhi run via -ExecCmds
+static void DumpPortalCaptureStats(const TArray<FString>& Args, UWorld* World)
+{
+    if (!World) return;
+
+    int32 NumPortals = 0;
+    for (TActorIterator<APortal> It(World); It; ++It)
+    {
+        UE_LOG(LogGAM415Project, Display,
+               TEXT("Portal %s: %d captures, %d skipped (%d distance, %d back facing, %d not rendered, %d frustum), %d deferred by the budget"),
+               *It->GetName(), It->GetNumCaptures(), It->GetNumSkippedCaptures(),
+               It->GetNumSkippedCaptures(EPortalVisibility::TooFar), It->GetNumSkippedCaptures(EPortalVisibility::BackFacing),
+               It->GetNumSkippedCaptures(EPortalVisibility::NotRendered), It->GetNumSkippedCaptures(EPortalVisibility::OutsideFrustum),
+               It->GetNumDeferredCaptures());
+        NumPortals++;
+    }
+    UE_LOG(LogGAM415Project, Display, TEXT("%d portals"), NumPortals);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GPortalCaptureStatsCommand(
+    TEXT("Portal.CaptureStats"),
+    TEXT("Logs the number of scene captures each portal issued, skipped and deferred since it started."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpPortalCaptureStats));
+
+// Checks the oblique projection against a plain one on the CPU: the plane lands on the near plane,
+// points in front of it are clipped, points beyond it keep a valid depth and X/Y are unchanged
+static void TestObliqueProjection(const TArray<FString>& Args, UWorld* World)
+{
+    const FVector ViewLocation(-200.0, 30.0, 50.0);
+    const FRotator ViewRotation(-10.0, 15.0, 0.0);
+    const FIntPoint Size(1280, 720);
+    const float FOV = 90.0f;
+
+    // A tilted plane 300 units ahead of the camera, kept side facing away from it
+    const FVector PlaneNormal = FRotator(5.0, 25.0, 0.0).Vector();
+    const FVector PlaneBase = ViewLocation + ViewRotation.Vector() * 300.0;
+    const FPlane ClipPlane(PlaneBase, PlaneNormal);
+
+    const FMatrix View = FTranslationMatrix(-ViewLocation) * APortal::GetViewRotationMatrix(ViewRotation);
+    const FMatrix Plain = View * FReversedZPerspectiveMatrix(FMath::DegreesToRadians(FOV * 0.5f), Size.X, Size.Y, GNearClippingPlane);
+    const FMatrix Oblique = View * APortal::MakeObliqueProjection(ViewLocation, ViewRotation, FOV, Size, ClipPlane);
+
+    FVector AxisU, AxisV;
+    PlaneNormal.FindBestAxisVectors(AxisU, AxisV);
+
+    int32 NumFailures = 0;
+    auto Check = [&NumFailures](bool bPassed, const TCHAR* What, const FVector& Point, double Depth)
+    {
+        if (bPassed) return;
+        UE_LOG(LogGAM415Project, Error, TEXT("Oblique projection: %s failed at %s (depth %f)"), What, *Point.ToString(), Depth);
+        NumFailures++;
+    };
+
+    FRandomStream Random(48);
+    for (int32 i = 0; i < 256; i++)
+    {
+        const FVector Offset = AxisU * Random.FRandRange(-200.0f, 200.0f) + AxisV * Random.FRandRange(-200.0f, 200.0f);
+
+        const FVector OnPlane = PlaneBase + Offset;
+        const FVector4 OnPlaneClip = Oblique.TransformFVector4(FVector4(OnPlane, 1.0));
+        const double OnPlaneDepth = OnPlaneClip.Z / OnPlaneClip.W;
+        Check(FMath::IsNearlyEqual(OnPlaneDepth, 1.0, 1e-3), TEXT("plane on near plane"), OnPlane, OnPlaneDepth);
+
+        const FVector Before = OnPlane - PlaneNormal * Random.FRandRange(1.0f, 250.0f);
+        const FVector4 BeforeClip = Oblique.TransformFVector4(FVector4(Before, 1.0));
+        if (BeforeClip.W > 0.0)
+            Check(BeforeClip.Z / BeforeClip.W > 1.0, TEXT("clip before plane"), Before, BeforeClip.Z / BeforeClip.W);
+
+        const FVector Beyond = OnPlane + PlaneNormal * Random.FRandRange(1.0f, 1.0e6f);
+        const FVector4 BeyondClip = Oblique.TransformFVector4(FVector4(Beyond, 1.0));
+        const FVector4 PlainClip = Plain.TransformFVector4(FVector4(Beyond, 1.0));
+        const double BeyondDepth = BeyondClip.Z / BeyondClip.W;
+        const bool bInFrustum = PlainClip.W > 0.0 && FMath::Abs(PlainClip.X) <= PlainClip.W && FMath::Abs(PlainClip.Y) <= PlainClip.W;
+        if (bInFrustum)
+            Check(BeyondDepth >= 0.0 && BeyondDepth < 1.0, TEXT("keep beyond plane"), Beyond, BeyondDepth);
+        Check(FMath::IsNearlyEqual(BeyondClip.X, PlainClip.X) && FMath::IsNearlyEqual(BeyondClip.Y, PlainClip.Y) &&
+              FMath::IsNearlyEqual(BeyondClip.W, PlainClip.W), TEXT("unchanged X/Y"), Beyond, BeyondDepth);
+    }
+
+    // A camera already past the plane gets the plain projection
+    const FMatrix Fallback = APortal::MakeObliqueProjection(PlaneBase + PlaneNormal * 10.0, ViewRotation, FOV, Size, ClipPlane);
+    const FMatrix PlainProjection = FReversedZPerspectiveMatrix(FMath::DegreesToRadians(FOV * 0.5f), Size.X, Size.Y, GNearClippingPlane);
+    Check(Fallback.Equals(PlainProjection), TEXT("fallback past plane"), PlaneBase, 0.0);
+
+    if (NumFailures == 0)
+        UE_LOG(LogGAM415Project, Display, TEXT("Oblique projection: all checks passed"));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GPortalTestObliqueCommand(
+    TEXT("Portal.TestObliqueProjection"),
+    TEXT("Checks the portal capture's oblique near plane projection on the CPU and logs any failures. Needs no GPU."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&TestObliqueProjection));
+
+// Places views around a temporary portal pair and ticks UPortalSubsystem with each in place of the
+// players' cameras, checking that only the visible view captures and the others are skipped under
+// the expected reason. The render time test is bypassed, since nothing is drawn under -nullrhi.
+// Usage: Portal.TestVisibility
+static void TestPortalVisibility(const TArray<FString>& Args, UWorld* World)
+{
+    UPortalSubsystem* Portals = World ? World->GetSubsystem<UPortalSubsystem>() : nullptr;
+    if (!Portals)
+    {
+        UE_LOG(LogGAM415Project, Warning, TEXT("Portal.TestVisibility needs a game world"));
+        return;
+    }
+
+    // Use the level's portal class when there is one, so its mesh gives the surface real bounds
+    TSubclassOf<APortal> PortalClass = APortal::StaticClass();
+    if (TActorIterator<APortal> It(World); It)
+        PortalClass = It->GetClass();
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    SpawnParams.ObjectFlags |= RF_Transient;
+
+    // Far from the level, facing +X
+    const FVector PortalLocation(0.0, 0.0, 1.0e6);
+    APortal* Portal = World->SpawnActor<APortal>(PortalClass, PortalLocation, FRotator::ZeroRotator, SpawnParams);
+    APortal* Linked = World->SpawnActor<APortal>(PortalClass, PortalLocation + FVector(0.0, 5000.0, 0.0), FRotator::ZeroRotator, SpawnParams);
+    if (!Portal || !Linked)
+    {
+        UE_LOG(LogGAM415Project, Error, TEXT("Portal visibility: could not spawn test portals"));
+        return;
+    }
+    Portal->SetLinkedPortal(Linked);
+
+    auto MakeView = [](const FVector& Location, const FRotator& Rotation)
+    {
+        FPortalView View;
+        View.Location = Location;
+        View.Rotation = Rotation;
+        View.ViewSize = FVector2D(1280.0, 720.0);
+        const FMatrix ViewProjection = FTranslationMatrix(-Location) * APortal::GetViewRotationMatrix(Rotation) *
+            FReversedZPerspectiveMatrix(FMath::DegreesToRadians(View.FOV * 0.5f), View.ViewSize.X, View.ViewSize.Y, GNearClippingPlane);
+        GetViewFrustumBounds(View.Frustum, ViewProjection, false);
+        View.bHasFrustum = true;
+        return View;
+    };
+
+    // The surface is seen from behind the portal's forward vector
+    struct FCase { const TCHAR* Name; FPortalView View; EPortalVisibility Expected; };
+    const FCase Cases[] =
+    {
+        { TEXT("in front, looking at it"), MakeView(PortalLocation - FVector(500.0, 0.0, 0.0), FRotator::ZeroRotator), EPortalVisibility::Visible },
+        { TEXT("behind it"), MakeView(PortalLocation + FVector(500.0, 0.0, 0.0), FRotator(0.0, 180.0, 0.0)), EPortalVisibility::BackFacing },
+        { TEXT("past the capture distance"), MakeView(PortalLocation - FVector(Portal->MaxCaptureDistance + 1000.0, 0.0, 0.0), FRotator::ZeroRotator), EPortalVisibility::TooFar },
+        { TEXT("in front, looking away"), MakeView(PortalLocation - FVector(500.0, 0.0, 0.0), FRotator(0.0, 180.0, 0.0)), EPortalVisibility::OutsideFrustum },
+    };
+
+    int32 NumFailures = 0;
+    for (const FCase& Case : Cases)
+    {
+        const int32 CapturesBefore = Portal->GetNumCaptures() + Portal->GetNumDeferredCaptures();
+        const int32 SkippedBefore = Portal->GetNumSkippedCaptures();
+        const int32 ReasonBefore = Portal->GetNumSkippedCaptures(Case.Expected);
+
+        Portals->SetViewOverride(MakeArrayView(&Case.View, 1), false);
+        Portals->Tick(0.0f);
+        Portals->ClearViewOverride();
+
+        // The visible view captures, or is deferred by the budget; the others capture nothing and
+        // count one skip, under their reason
+        const bool bVisible = Case.Expected == EPortalVisibility::Visible;
+        const int32 CapturesAdded = Portal->GetNumCaptures() + Portal->GetNumDeferredCaptures() - CapturesBefore;
+        const int32 SkippedAdded = Portal->GetNumSkippedCaptures() - SkippedBefore;
+        const int32 ReasonAdded = Portal->GetNumSkippedCaptures(Case.Expected) - ReasonBefore;
+        const bool bPassed = bVisible ? CapturesAdded == 1 && SkippedAdded == 0
+                                      : CapturesAdded == 0 && SkippedAdded == 1 && ReasonAdded == 1;
+        if (!bPassed)
+        {
+            UE_LOG(LogGAM415Project, Error, TEXT("Portal visibility: view %s (expected reason %d) added %d captures, %d skips, %d under the expected reason"),
+                   Case.Name, int32(Case.Expected), CapturesAdded, SkippedAdded, ReasonAdded);
+            NumFailures++;
+        }
+    }
+
+    // Projectiles simulated without actors enter through the side the views above see, and only
+    // there, then leave the linked portal's seen side moving away from it
+    struct FEntryCase { const TCHAR* Name; FVector Start; FVector End; bool bExpected; };
+    const FEntryCase EntryCases[] =
+    {
+        { TEXT("into the seen side"), PortalLocation - FVector(100.0, 0.0, 0.0), PortalLocation + FVector(100.0, 0.0, 0.0), true },
+        { TEXT("into the back"), PortalLocation + FVector(100.0, 0.0, 0.0), PortalLocation - FVector(100.0, 0.0, 0.0), false },
+        { TEXT("short of the surface"), PortalLocation - FVector(100.0, 0.0, 0.0), PortalLocation - FVector(50.0, 0.0, 0.0), false },
+    };
+    for (const FEntryCase& Case : EntryCases)
+    {
+        float Time = 0.0f;
+        const bool bEntered = Portal->FindEntry(Case.Start, Case.End, 10.0f, Time);
+        if (bEntered != Case.bExpected)
+        {
+            UE_LOG(LogGAM415Project, Error, TEXT("Portal entry: path %s %s"), Case.Name,
+                   bEntered ? TEXT("entered the portal") : TEXT("did not enter the portal"));
+            NumFailures++;
+        }
+        if (!bEntered) continue;
+
+        FVector Location = FMath::Lerp(Case.Start, Case.End, Time);
+        FVector Velocity = Case.End - Case.Start;
+        Portal->TransformThroughPortal(Location, Velocity);
+        const FVector ToExit = Location - Linked->GetActorLocation();
+        const FVector LinkedFront = -Linked->GetActorForwardVector();
+        if (FVector::DotProduct(ToExit, LinkedFront) < 0.0 || FVector::DotProduct(Velocity, LinkedFront) <= 0.0)
+        {
+            UE_LOG(LogGAM415Project, Error, TEXT("Portal entry: path %s left the linked portal at %s moving %s, not out of its seen side"),
+                   Case.Name, *ToExit.ToString(), *Velocity.ToString());
+            NumFailures++;
+        }
+    }
+
+    Portal->Destroy();
+    Linked->Destroy();
+
+    if (NumFailures == 0)
+        UE_LOG(LogGAM415Project, Display, TEXT("Portal visibility: all checks passed"));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GPortalTestVisibilityCommand(
+    TEXT("Portal.TestVisibility"),
+    TEXT("Spawns a temporary portal pair, ticks the portal subsystem with views in front of, behind, too far from and facing away from it, checks which paths enter it, and logs an error for every unexpected result. Needs no GPU."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&TestPortalVisibility));
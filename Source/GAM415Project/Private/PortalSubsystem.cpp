@@ -0,0 +1,179 @@
+#include "PortalSubsystem.h"
+#include "Portal.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+static TAutoConsoleVariable<int32> CVarPortalFullRateCaptures(
+    TEXT("Portal.FullRateCaptures"),
+    2,
+    TEXT("Number of visible portal views, largest on screen first, that capture every frame."));
+
+static TAutoConsoleVariable<int32> CVarPortalRoundRobinCaptures(
+    TEXT("Portal.RoundRobinCaptures"),
+    1,
+    TEXT("Captures per frame shared in turn by the visible portals beyond Portal.FullRateCaptures."));
+
+static TAutoConsoleVariable<int32> CVarPortalRecursionBudget(
+    TEXT("Portal.RecursionBudget"),
+    4,
+    TEXT("Extra captures per frame all portals may spend on recursive views of themselves, largest portals first."));
+
+static TAutoConsoleVariable<int32> CVarPortalRenderTargetPoolSize(
+    TEXT("Portal.RenderTargetPoolSize"),
+    4,
+    TEXT("Number of free portal render targets kept for reuse; older ones are released."));
+
+bool UPortalSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UPortalSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UPortalSubsystem, STATGROUP_Tickables);
+}
+
+void UPortalSubsystem::RegisterPortal(APortal* Portal)
+{
+    if (Portal) Portals.AddUnique(Portal);
+}
+
+void UPortalSubsystem::UnregisterPortal(APortal* Portal)
+{
+    Portals.Remove(Portal);
+}
+
+void UPortalSubsystem::SetViewOverride(TConstArrayView<FPortalView> InViews, bool bInCheckRendered)
+{
+    OverrideViews.Reset();
+    OverrideViews.Append(InViews.GetData(), InViews.Num());
+    bOverrideViews = true;
+    bCheckRendered = bInCheckRendered;
+}
+
+void UPortalSubsystem::ClearViewOverride()
+{
+    OverrideViews.Reset();
+    bOverrideViews = false;
+    bCheckRendered = true;
+}
+
+void UPortalSubsystem::Tick(float DeltaTime)
+{
+    Portals.RemoveAll([](const APortal* Portal) { return !IsValid(Portal); });
+    if (Portals.IsEmpty()) return;
+
+    // One view per local player; split-screen players each see their own capture.
+    Views.Reset();
+    if (bOverrideViews)
+    {
+        Views.Append(OverrideViews);
+    }
+    else
+    {
+        for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+        {
+            const APlayerController* PlayerController = It->Get();
+            if (!PlayerController || !PlayerController->IsLocalPlayerController()) continue;
+
+            FPortalView View;
+            if (APortal::GetPlayerView(PlayerController, View))
+            {
+                Views.Add(MoveTemp(View));
+            }
+        }
+    }
+    if (Views.IsEmpty()) return;
+
+    // Rank the portals by how much of each view they cover, skipping views they cannot be seen in.
+    Candidates.Reset();
+    for (APortal* Portal : Portals)
+    {
+        if (!Portal->HasLinkedPortal()) continue;
+
+        for (int32 ViewSlot = 0; ViewSlot < Views.Num(); ViewSlot++)
+        {
+            const FPortalView& View = Views[ViewSlot];
+            const EPortalVisibility Visibility = Portal->GetVisibility(View, bCheckRendered);
+            if (Visibility != EPortalVisibility::Visible)
+            {
+                Portal->RecordSkippedCapture(View, Visibility);
+                continue;
+            }
+            Candidates.Add({ Portal, ViewSlot, Portal->GetScreenCoverage(View) });
+        }
+    }
+
+    Candidates.Sort([](const FPortalCandidate& A, const FPortalCandidate& B)
+    {
+        return A.ScreenCoverage > B.ScreenCoverage;
+    });
+
+    // Recursive views are spent in rank order, so the largest portals recurse deepest.
+    int32 RecursionBudget = FMath::Max(CVarPortalRecursionBudget.GetValueOnGameThread(), 0);
+
+    const int32 NumFullRate = FMath::Clamp(CVarPortalFullRateCaptures.GetValueOnGameThread(), 0, Candidates.Num());
+    for (int32 i = 0; i < NumFullRate; i++)
+    {
+        RecursionBudget -= Candidates[i].Portal->CaptureView(Views[Candidates[i].ViewSlot], RecursionBudget);
+    }
+
+    // The rest take turns, least recently captured first.
+    TArrayView<FPortalCandidate> Remaining = TArrayView<FPortalCandidate>(Candidates).RightChop(NumFullRate);
+    Remaining.Sort([this](const FPortalCandidate& A, const FPortalCandidate& B)
+    {
+        return A.Portal->GetLastCaptureFrame(Views[A.ViewSlot]) < B.Portal->GetLastCaptureFrame(Views[B.ViewSlot]);
+    });
+
+    const int32 NumRoundRobin = FMath::Clamp(CVarPortalRoundRobinCaptures.GetValueOnGameThread(), 0, Remaining.Num());
+    for (int32 i = 0; i < Remaining.Num(); i++)
+    {
+        const FPortalView& View = Views[Remaining[i].ViewSlot];
+        if (i < NumRoundRobin)
+        {
+            RecursionBudget -= Remaining[i].Portal->CaptureView(View, RecursionBudget);
+        }
+        else
+        {
+            Remaining[i].Portal->RecordDeferredCapture(View);
+        }
+    }
+}
+
+UTextureRenderTarget2D* UPortalSubsystem::AcquireRenderTarget(const FIntPoint& Size, ETextureRenderTargetFormat Format)
+{
+    NumLentRenderTargets++;
+
+    // Most recently returned first, as it is the likeliest to still be resident.
+    for (int32 i = FreeRenderTargets.Num() - 1; i >= 0; i--)
+    {
+        UTextureRenderTarget2D* RenderTarget = FreeRenderTargets[i];
+        if (RenderTarget->SizeX == Size.X && RenderTarget->SizeY == Size.Y && RenderTarget->RenderTargetFormat == Format)
+        {
+            FreeRenderTargets.RemoveAt(i, 1, EAllowShrinking::No);
+            return RenderTarget;
+        }
+    }
+
+    UTextureRenderTarget2D* RenderTarget = NewObject<UTextureRenderTarget2D>(this);
+    RenderTarget->RenderTargetFormat = Format;
+    RenderTarget->ClearColor = FLinearColor::Black;
+    RenderTarget->InitAutoFormat(Size.X, Size.Y);
+    return RenderTarget;
+}
+
+void UPortalSubsystem::ReleaseRenderTarget(UTextureRenderTarget2D* RenderTarget)
+{
+    if (!RenderTarget) return;
+
+    NumLentRenderTargets = FMath::Max(NumLentRenderTargets - 1, 0);
+    FreeRenderTargets.Add(RenderTarget);
+
+    // Dropped targets free their GPU memory once garbage collected.
+    const int32 MaxFree = FMath::Max(CVarPortalRenderTargetPoolSize.GetValueOnGameThread(), 0);
+    if (FreeRenderTargets.Num() > MaxFree)
+    {
+        FreeRenderTargets.RemoveAt(0, FreeRenderTargets.Num() - MaxFree, EAllowShrinking::No);
+    }
+}
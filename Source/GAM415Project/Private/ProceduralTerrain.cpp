@@ -1,5 +1,37 @@
 #include "ProceduralTerrain.h"
+#include "GAM415Project.h"
+#include "TerrainGenerator.h"
+#include "TerrainHeightCache.h"
 #include "Kismet/GameplayStatics.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+namespace
+{
+    // UVs depend only on a vertex's grid position, so every chunk of a given size shares one buffer.
+    const TArray<FVector2D>& GetSharedChunkUVs(int32 ChunkSize)
+    {
+        check(IsInGameThread());
+
+        static TMap<int32, TArray<FVector2D>> SharedUVs;
+        TArray<FVector2D>& UVs = SharedUVs.FindOrAdd(ChunkSize);
+
+        if (UVs.IsEmpty())
+        {
+            // Compute inverse chunk size for UV mapping
+            const float InvChunkSize = 1.0f / (ChunkSize - 1);
+
+            UVs.Reserve(ChunkSize * ChunkSize);
+            for (int32 x = 0; x < ChunkSize; x++)
+            {
+                for (int32 y = 0; y < ChunkSize; y++)
+                {
+                    UVs.Add(FVector2D(x * InvChunkSize, y * InvChunkSize));
+                }
+            }
+        }
+        return UVs;
+    }
+}
 
 AProceduralTerrain::AProceduralTerrain()
 {
@@ -10,6 +42,9 @@ AProceduralTerrain::AProceduralTerrain()
     ProceduralMesh = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("ProceduralMesh"));
     ProceduralMesh->SetupAttachment(RootComponent);
 
+    // Persistent paint accumulated over the whole terrain.
+    PaintLayer = CreateDefaultSubobject<UTerrainPaintComponent>(TEXT("PaintLayer"));
+
     PrimaryActorTick.bCanEverTick = false; // This actor does not need ticking
 }
 
@@ -19,6 +54,12 @@ void AProceduralTerrain::OnConstruction(const FTransform& Transform)
     GenerateTerrain();
 }
 
+void AProceduralTerrain::BeginPlay()
+{
+    Super::BeginPlay();
+    RestoreRuntimeState();
+}
+
 // Generates the terrain by creating mesh sections for each chunk.
 void AProceduralTerrain::GenerateTerrain()
 {
@@ -29,16 +70,44 @@ void AProceduralTerrain::GenerateTerrain()
     const float ChunkWorldSize = (ChunkSize - 1) * Scale;
 
     // Determine how many chunks are needed along X and Y.
-    const FIntPoint NumChunks(FMath::CeilToInt(XSize / ChunkWorldSize),
-                              FMath::CeilToInt(YSize / ChunkWorldSize));
+    NumChunks = FIntPoint(FMath::CeilToInt(XSize / ChunkWorldSize),
+                          FMath::CeilToInt(YSize / ChunkWorldSize));
 
     // Compute total world dimensions and half sizes.
     const FVector2D TotalWorldSize = NumChunks * ChunkWorldSize;
     const FVector2D HalfWorldSize = TotalWorldSize / 2;
 
+    // Sample every vertex height once (chunks share their borders), then erode if enabled.
+    TArray<float> Heightfield;
+    GenerateHeightfield(Heightfield);
+
     // Reserve memory for chunk data.
     Chunks.Reserve(NumChunks.X * NumChunks.Y);
 
+    // Lay out the height pyramid over the chunk grid; each chunk fills its part below.
+    HeightPyramid.Init(NumChunks, ChunkSize, Scale, -HalfWorldSize);
+
+    // One UV buffer serves every chunk.
+    const TArray<FVector2D>& UVs = GetSharedChunkUVs(ChunkSize);
+
+    // Every chunk shares one material instance, which also carries the paint layer's parameters.
+    if (TerrainMaterial && (!TerrainMaterialInstance || TerrainMaterialInstance->Parent != TerrainMaterial))
+    {
+        TerrainMaterialInstance = UMaterialInstanceDynamic::Create(TerrainMaterial, this);
+    }
+    else if (!TerrainMaterial)
+    {
+        TerrainMaterialInstance = nullptr;
+    }
+
+    // Normals at chunk borders read their neighbours from the heightfield.
+    const FIntPoint HeightfieldSize = GetHeightfieldSize();
+    auto SampleHeightfield = [&Heightfield, HeightfieldSize](int32 GridX, int32 GridY)
+    {
+        return Heightfield[FMath::Clamp(GridX, 0, HeightfieldSize.X - 1) * HeightfieldSize.Y +
+                           FMath::Clamp(GridY, 0, HeightfieldSize.Y - 1)];
+    };
+
     int32 SectionIndex = 0;
     // Loop through each grid coordinate and generate a chunk section.
     for (int32 x = 0; x < NumChunks.X; x++)
@@ -53,25 +122,29 @@ void AProceduralTerrain::GenerateTerrain()
 
             // Containers for mesh data.
             TArray<FVector> Vertices;
-            TArray<FVector2D> UVs;
             TArray<int32> Triangles;
 
-            // Generate vertices, UVs, and triangles.
+            // Generate vertices and triangles.
             // The vertices will be offset by ChunkCenter so that each chunk is in its own location.
-            GenerateMeshData(ChunkCenter, Vertices, UVs, Triangles);
+            GenerateMeshData(ChunkCenter, FIntPoint(x, y), Heightfield, Vertices, Triangles);
 
-            // Calculate normals for proper lighting.
+            // Calculate normals and tangents for proper lighting.
             TArray<FVector> Normals;
-            CalculateNormals(Vertices, Triangles, Normals);
+            TArray<FProcMeshTangent> Tangents;
+            CalculateNormalsAndTangents(FIntPoint(x, y), Vertices, SampleHeightfield, Normals, Tangents);
 
-            // Create the mesh section for this chunk.
-            ProceduralMesh->CreateMeshSection_LinearColor(SectionIndex, Vertices, Triangles, Normals, UVs, 
-                                                          TArray<FLinearColor>(), TArray<FProcMeshTangent>(), true);
+            // Derive the material layer weights from height and slope.
+            TArray<FColor> LayerWeights;
+            GenerateLayerWeights(Vertices, Normals, LayerWeights);
+
+            // Create the mesh section for this chunk. The packed layer weights go straight in as vertex colors.
+            ProceduralMesh->CreateMeshSection(SectionIndex, Vertices, Triangles, Normals, UVs,
+                                              LayerWeights, Tangents, true);
 
             // Set the material if provided.
-            if (TerrainMaterial)
+            if (TerrainMaterialInstance)
             {
-                ProceduralMesh->SetMaterial(SectionIndex, TerrainMaterial);
+                ProceduralMesh->SetMaterial(SectionIndex, TerrainMaterialInstance);
             }
 
             // Save the generated chunk data for later use (e.g., for modifying terrain)
@@ -80,11 +153,54 @@ void AProceduralTerrain::GenerateTerrain()
             NewChunkData.MaxBounds = FVector2D(ChunkCenter.X + HalfChunkSize, ChunkCenter.Y + HalfChunkSize);
             NewChunkData.Vertices = Vertices;
             NewChunkData.Triangles = Triangles;
+            NewChunkData.LayerWeights = MoveTemp(LayerWeights);
             Chunks.Add(NewChunkData);
 
+            HeightPyramid.BuildChunk(SectionIndex, Vertices);
+
             SectionIndex++;
         }
     }
+
+    // Start with a clean paint layer covering the new chunk grid.
+    PaintLayer->Init(FBox2D(-HalfWorldSize, HalfWorldSize), TerrainMaterialInstance);
+}
+
+// Chunks, NumChunks and the mesh sections are saved with the level, but the height pyramid, the
+// paint texels and the transient material instance are not.
+void AProceduralTerrain::RestoreRuntimeState()
+{
+    if (Chunks.IsEmpty() || Chunks.Num() != NumChunks.X * NumChunks.Y)
+    {
+        return;
+    }
+
+    // The first and last chunks hold the grid's corners.
+    const FVector2D WorldMin = Chunks[0].MinBounds;
+    const FVector2D WorldMax = Chunks.Last().MaxBounds;
+
+    if (!HeightPyramid.IsInitialized())
+    {
+        HeightPyramid.Init(NumChunks, ChunkSize, Scale, WorldMin);
+        for (const FChunkData& Chunk : Chunks)
+        {
+            HeightPyramid.BuildChunk(Chunk.SectionIndex, Chunk.Vertices);
+        }
+    }
+
+    if (TerrainMaterial && !TerrainMaterialInstance)
+    {
+        TerrainMaterialInstance = UMaterialInstanceDynamic::Create(TerrainMaterial, this);
+        for (const FChunkData& Chunk : Chunks)
+        {
+            ProceduralMesh->SetMaterial(Chunk.SectionIndex, TerrainMaterialInstance);
+        }
+    }
+
+    if (!PaintLayer->IsInitialized())
+    {
+        PaintLayer->Init(FBox2D(WorldMin, WorldMax), TerrainMaterialInstance);
+    }
 }
 
 // Clears all mesh sections and resets chunk data.
@@ -95,6 +211,9 @@ void AProceduralTerrain::ClearChunks()
         ProceduralMesh->ClearAllMeshSections();
     }
     Chunks.Empty();
+    DirtyChunks.Empty();
+    NumChunks = FIntPoint::ZeroValue;
+    HeightPyramid.Reset();
 }
 
 // Calculates the center position of a chunk in actor-local space based on grid coordinates.
@@ -106,12 +225,12 @@ FVector AProceduralTerrain::CalculateChunkCenter(int32 ChunkX, int32 ChunkY, flo
                    0);
 }
 
-// Generates geometry for a single chunk: vertices, UVs, and triangles.
-void AProceduralTerrain::GenerateMeshData(const FVector& ChunkCenter, TArray<FVector>& Vertices, TArray<FVector2D>& UVs, TArray<int32>& Triangles) const
+// Generates geometry for a single chunk: vertices and triangles.
+void AProceduralTerrain::GenerateMeshData(const FVector& ChunkCenter, const FIntPoint& ChunkCoords, const TArray<float>& Heightfield,
+                                          TArray<FVector>& Vertices, TArray<int32>& Triangles) const
 {
     const int32 TotalVertices = ChunkSize * ChunkSize;
     Vertices.Reserve(TotalVertices);
-    UVs.Reserve(TotalVertices);
 
     const int32 TotalQuads = (ChunkSize - 1) * (ChunkSize - 1);
     Triangles.Reserve(TotalQuads * 6);
@@ -122,8 +241,9 @@ void AProceduralTerrain::GenerateMeshData(const FVector& ChunkCenter, TArray<FVe
     // Local offset to center the grid on (0,0).
     const FVector GridOffset = FVector(FullChunkSize * 0.5f, FullChunkSize * 0.5f, 0);
 
-    // Compute inverse chunk size for UV mapping
-    const float InvChunkSize = 1.0f / (ChunkSize - 1);
+    // Position of this chunk's first vertex in the shared heightfield.
+    const int32 HeightfieldSizeY = GetHeightfieldSize().Y;
+    const FIntPoint HeightfieldOffset = ChunkCoords * (ChunkSize - 1);
 
     // Loop through the grid.
     for (int32 x = 0; x < ChunkSize; x++)
@@ -137,11 +257,8 @@ void AProceduralTerrain::GenerateMeshData(const FVector& ChunkCenter, TArray<FVe
         // Compute final vertex X position in actor-local space.
         const float FinalPosX = LocalPosX + ChunkCenter.X;
 
-        // Compute world X position by adding the actor's X location.
-        const float WorldPosX = FinalPosX + GetActorLocation().X;
-
-        // Compute the UV's X value
-        const float UVValX = x * InvChunkSize;
+        // Compute the heightfield row of this column.
+        const int32 HeightfieldRow = (HeightfieldOffset.X + x) * HeightfieldSizeY + HeightfieldOffset.Y;
 
         for (int32 y = 0; y < ChunkSize; y++)
         {
@@ -154,17 +271,10 @@ void AProceduralTerrain::GenerateMeshData(const FVector& ChunkCenter, TArray<FVe
             // Compute final vertex Y position in actor-local space.
             const float FinalPosY = LocalPosY + ChunkCenter.Y;
 
-            // Compute world Y position by adding the actor's Y location.
-            const float WorldPosY = FinalPosY + GetActorLocation().Y;
-
-            // Compute the UV's Y value
-            const float UVValY = y * InvChunkSize;
-
-            // Use world space to compute height using noise.
-            const float FinalPosZ = GetHeightAtWorldPosition(WorldPosX, WorldPosY);
+            // Read the height sampled for this vertex.
+            const float FinalPosZ = Heightfield[HeightfieldRow + y];
 
             Vertices.Add(FVector(FinalPosX, FinalPosY, FinalPosZ));
-            UVs.Add(FVector2D(UVValX, UVValY));
 
             // Generate triangles (except on the boundary).
             if (x < ChunkSize - 1 && y < ChunkSize - 1)
@@ -188,42 +298,264 @@ void AProceduralTerrain::GenerateMeshData(const FVector& ChunkCenter, TArray<FVe
     }
 }
 
-// Uses Perlin noise to compute the height at a given world coordinate.
-float AProceduralTerrain::GetHeightAtWorldPosition(float WorldX, float WorldY) const
+FIntPoint AProceduralTerrain::GetHeightfieldSize() const
+{
+    return NumChunks * (ChunkSize - 1) + FIntPoint(1, 1);
+}
+
+FTerrainGenerationParams AProceduralTerrain::GetGenerationParams() const
+{
+    FTerrainGenerationParams Params;
+    Params.Origin = FVector2D(GetActorLocation());
+    Params.XSize = XSize;
+    Params.YSize = YSize;
+    Params.Scale = Scale;
+    Params.HeightScale = HeightScale;
+    Params.NoiseScale = NoiseScale;
+    Params.ChunkSize = ChunkSize;
+    Params.Seed = Seed;
+    Params.bEnableErosion = bEnableErosion;
+    Params.ErosionSettings = ErosionSettings;
+    return Params;
+}
+
+// Fills the heightfield for the whole chunk grid, preferring prebaked or cached heights on disk.
+void AProceduralTerrain::GenerateHeightfield(TArray<float>& OutHeights) const
+{
+    const FTerrainGenerationParams Params = GetGenerationParams();
+    const FIntPoint GridSize = GetHeightfieldSize();
+    check(Params.GetHeightfieldSize() == GridSize);
+
+    const uint64 CacheKey = Params.GetCacheKey();
+    if (FTerrainHeightCache::Load(CacheKey, GridSize, OutHeights)) return;
+
+    const FTerrainErosionStats Stats = FTerrainGenerator::GenerateHeightfield(Params, OutHeights);
+    if (!bEnableErosion) return;
+
+    UE_LOG(LogGAM415Project, Log, TEXT("%s: eroded %lld droplets in %.1f ms"), *GetName(), Stats.Droplets, Stats.Seconds * 1000.0);
+
+    if (bCacheErosion)
+    {
+        FTerrainHeightCache::Save(CacheKey, GridSize, OutHeights);
+    }
+}
+
+// Calculates normals and tangents from central differences of the heights in one pass.
+// Unlike accumulating face normals this needs no triangle walk, and border vertices see their
+// neighbours in adjacent chunks, so lighting matches across chunk seams.
+void AProceduralTerrain::CalculateNormalsAndTangents(const FIntPoint& ChunkCoords, const TArray<FVector>& Vertices,
+                                                     TFunctionRef<float(int32 GridX, int32 GridY)> SampleGridHeight,
+                                                     TArray<FVector>& Normals, TArray<FProcMeshTangent>& Tangents) const
+{
+    Normals.SetNumUninitialized(Vertices.Num());
+    Tangents.SetNumUninitialized(Vertices.Num());
+
+    const FIntPoint GridOffset = ChunkCoords * (ChunkSize - 1);
+    const FIntPoint GridSize = GetHeightfieldSize();
+
+    // Reads from the chunk itself when possible, otherwise from the neighbouring chunk.
+    auto HeightAt = [&](int32 x, int32 y) -> float
+    {
+        if (x >= 0 && y >= 0 && x < ChunkSize && y < ChunkSize) return Vertices[x * ChunkSize + y].Z;
+        return SampleGridHeight(GridOffset.X + x, GridOffset.Y + y);
+    };
+
+    for (int32 x = 0; x < ChunkSize; x++)
+    {
+        // Terrain edges fall back to one-sided differences.
+        const int32 PrevX = GridOffset.X + x > 0 ? x - 1 : x;
+        const int32 NextX = GridOffset.X + x < GridSize.X - 1 ? x + 1 : x;
+
+        for (int32 y = 0; y < ChunkSize; y++)
+        {
+            const int32 PrevY = GridOffset.Y + y > 0 ? y - 1 : y;
+            const int32 NextY = GridOffset.Y + y < GridSize.Y - 1 ? y + 1 : y;
+
+            const float SlopeX = (HeightAt(NextX, y) - HeightAt(PrevX, y)) / ((NextX - PrevX) * Scale);
+            const float SlopeY = (HeightAt(x, NextY) - HeightAt(x, PrevY)) / ((NextY - PrevY) * Scale);
+
+            const int32 i = x * ChunkSize + y;
+            Normals[i] = FVector(-SlopeX, -SlopeY, 1.0f).GetUnsafeNormal();
+
+            // U runs along X, so the tangent follows the surface in that direction.
+            Tangents[i] = FProcMeshTangent(FVector(1.0f, 0.0f, SlopeX).GetUnsafeNormal(), false);
+        }
+    }
+}
+
+// Reads a vertex height by terrain grid coordinates from whichever chunk owns it.
+float AProceduralTerrain::GetGridHeight(int32 GridX, int32 GridY) const
+{
+    const int32 NumCells = ChunkSize - 1;
+    const FIntPoint GridSize = GetHeightfieldSize();
+    GridX = FMath::Clamp(GridX, 0, GridSize.X - 1);
+    GridY = FMath::Clamp(GridY, 0, GridSize.Y - 1);
+
+    const int32 ChunkX = FMath::Min(GridX / NumCells, NumChunks.X - 1);
+    const int32 ChunkY = FMath::Min(GridY / NumCells, NumChunks.Y - 1);
+    const int32 VertexX = GridX - ChunkX * NumCells;
+    const int32 VertexY = GridY - ChunkY * NumCells;
+
+    return Chunks[ChunkX * NumChunks.Y + ChunkY].Vertices[VertexX * ChunkSize + VertexY].Z;
+}
+
+// Derives per-vertex layer weights: rock on steep slopes, snow up high, grass everywhere else.
+void AProceduralTerrain::GenerateLayerWeights(const TArray<FVector>& Vertices, const TArray<FVector>& Normals, TArray<FColor>& OutWeights) const
+{
+    OutWeights.SetNumUninitialized(Vertices.Num());
+
+    for (int32 i = 0; i < Vertices.Num(); ++i)
+    {
+        const float SlopeDegrees = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(FMath::Abs(Normals[i].Z), 0.0f, 1.0f)));
+        const float Rock = FMath::SmoothStep(RockSlopeRange.X, RockSlopeRange.Y, SlopeDegrees);
+        const float Snow = (1.0f - Rock) * FMath::SmoothStep(SnowHeightRange.X, SnowHeightRange.Y, Vertices[i].Z);
+
+        // Grass takes whatever is left so the weights always sum to exactly 255.
+        const int32 RockWeight = FMath::RoundToInt(Rock * 255.0f);
+        const int32 SnowWeight = FMath::Min(FMath::RoundToInt(Snow * 255.0f), 255 - RockWeight);
+        OutWeights[i] = FColor(static_cast<uint8>(255 - RockWeight - SnowWeight),
+                               static_cast<uint8>(RockWeight),
+                               static_cast<uint8>(SnowWeight), 0);
+    }
+}
+
+// Blends a layer in by lerping all weights toward that layer, which keeps their sum intact.
+void AProceduralTerrain::BlendLayerWeight(FColor& Weights, ETerrainLayer Layer, float Amount)
+{
+    uint8* Channels[4] = {&Weights.R, &Weights.G, &Weights.B, &Weights.A};
+    const int32 Target = static_cast<int32>(Layer);
+    const float Keep = 1.0f - FMath::Clamp(Amount, 0.0f, 1.0f);
+
+    int32 Others = 0;
+    for (int32 Channel = 0; Channel < 4; ++Channel)
+    {
+        if (Channel == Target) continue;
+        *Channels[Channel] = static_cast<uint8>(FMath::FloorToInt(*Channels[Channel] * Keep));
+        Others += *Channels[Channel];
+    }
+    *Channels[Target] = static_cast<uint8>(255 - Others);
+}
+
+// Finds the chunks under the bounding square straight from the chunk grid,
+// so the cost of a brush depends on the area it touches rather than the map size.
+void AProceduralTerrain::ForEachChunkInRadius(const FVector& Location, float Radius,
+                                              TFunctionRef<void(int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)> Visit)
+{
+    const float RadiusSq = FMath::Square(Radius);
+    const FBox2D Area(FVector2D(Location) - FVector2D(Radius), FVector2D(Location) + FVector2D(Radius));
+
+    ForEachChunkInArea(Area, [&](int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)
+    {
+        const FChunkData& Chunk = Chunks[ChunkIndex];
+
+        // Precise distance check: find the closest point in the chunk's bounds to the location
+        const float ClampedX = FMath::Clamp(Location.X, Chunk.MinBounds.X, Chunk.MaxBounds.X);
+        const float ClampedY = FMath::Clamp(Location.Y, Chunk.MinBounds.Y, Chunk.MaxBounds.Y);
+        const float DistanceSq = FVector::DistSquared2D(Location, FVector(ClampedX, ClampedY, 0));
+
+        if (DistanceSq <= RadiusSq)
+        {
+            Visit(ChunkIndex, MinVertex, MaxVertex);
+        }
+    });
+}
+
+void AProceduralTerrain::ForEachChunkInArea(const FBox2D& Area,
+                                            TFunctionRef<void(int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)> Visit)
+{
+    if (Chunks.Num() != NumChunks.X * NumChunks.Y || Chunks.IsEmpty()) return;
+
+    const float ChunkWorldSize = (ChunkSize - 1) * Scale;
+    const FVector2D GridOrigin = FVector2D(NumChunks) * ChunkWorldSize * -0.5f;
+    const FIntPoint MinChunk(FMath::Max(FMath::FloorToInt((Area.Min.X - GridOrigin.X) / ChunkWorldSize), 0),
+                             FMath::Max(FMath::FloorToInt((Area.Min.Y - GridOrigin.Y) / ChunkWorldSize), 0));
+    const FIntPoint MaxChunk(FMath::Min(FMath::FloorToInt((Area.Max.X - GridOrigin.X) / ChunkWorldSize), NumChunks.X - 1),
+                             FMath::Min(FMath::FloorToInt((Area.Max.Y - GridOrigin.Y) / ChunkWorldSize), NumChunks.Y - 1));
+
+    for (int32 ChunkX = MinChunk.X; ChunkX <= MaxChunk.X; ++ChunkX)
+    {
+        for (int32 ChunkY = MinChunk.Y; ChunkY <= MaxChunk.Y; ++ChunkY)
+        {
+            const int32 ChunkIndex = ChunkX * NumChunks.Y + ChunkY;
+            const FChunkData& Chunk = Chunks[ChunkIndex];
+
+            // Only the vertices inside the area can be affected.
+            const FIntPoint MinVertex(FMath::Max(FMath::CeilToInt((Area.Min.X - Chunk.MinBounds.X) / Scale), 0),
+                                      FMath::Max(FMath::CeilToInt((Area.Min.Y - Chunk.MinBounds.Y) / Scale), 0));
+            const FIntPoint MaxVertex(FMath::Min(FMath::FloorToInt((Area.Max.X - Chunk.MinBounds.X) / Scale), ChunkSize - 1),
+                                      FMath::Min(FMath::FloorToInt((Area.Max.Y - Chunk.MinBounds.Y) / Scale), ChunkSize - 1));
+
+            if (MinVertex.X > MaxVertex.X || MinVertex.Y > MaxVertex.Y) continue;
+
+            Visit(ChunkIndex, MinVertex, MaxVertex);
+        }
+    }
+}
+
+void AProceduralTerrain::MarkChunkDirty(int32 ChunkIndex, bool bGeometry, bool bLayers)
 {
-    return FMath::PerlinNoise2D(FVector2D(WorldX, WorldY) * NoiseScale) * HeightScale;
+    FChunkData& Chunk = Chunks[ChunkIndex];
+    Chunk.bGeometryDirty |= bGeometry;
+    Chunk.bLayersDirty |= bLayers;
+    DirtyChunks.AddUnique(ChunkIndex);
 }
 
-// Calculates normals for proper lighting based on vertices and triangle indices.
-void AProceduralTerrain::CalculateNormals(const TArray<FVector>& Vertices, const TArray<int32>& Triangles, TArray<FVector>& Normals) const
+// Normals read one vertex past the chunk border through GetGridHeight, so a height change within
+// one vertex of an edge also changes the normals along the neighbouring chunk's side of the seam.
+void AProceduralTerrain::MarkNeighbourNormalsDirty(int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)
 {
-    // Initialize normals array with zeros
-    Normals.SetNumZeroed(Vertices.Num());
+    const FIntPoint ChunkCoords(ChunkIndex / NumChunks.Y, ChunkIndex % NumChunks.Y);
+    const FIntPoint MinOffset(MinVertex.X <= 1 ? -1 : 0, MinVertex.Y <= 1 ? -1 : 0);
+    const FIntPoint MaxOffset(MaxVertex.X >= ChunkSize - 2 ? 1 : 0, MaxVertex.Y >= ChunkSize - 2 ? 1 : 0);
 
-    // Iterate over triangles (each triangle uses 3 consecutive indices)
-    for (int32 i = 0; i < Triangles.Num(); i += 3)
+    for (int32 OffsetX = MinOffset.X; OffsetX <= MaxOffset.X; ++OffsetX)
     {
-        const int32 i0 = Triangles[i];
-        const int32 i1 = Triangles[i + 1];
-        const int32 i2 = Triangles[i + 2];
-
-        // Compute two edges of the triangle
-        const FVector Edge1 = Vertices[i1] - Vertices[i0];
-        const FVector Edge2 = Vertices[i2] - Vertices[i0];
-        // Calculate face normal (cross product) and normalize it
-        const FVector FaceNormal = Edge1.Cross(Edge2).GetSafeNormal();
-
-        // Add the face normal to each vertex normal
-        Normals[i0] += FaceNormal;
-        Normals[i1] += FaceNormal;
-        Normals[i2] += FaceNormal;
+        for (int32 OffsetY = MinOffset.Y; OffsetY <= MaxOffset.Y; ++OffsetY)
+        {
+            const FIntPoint Neighbour = ChunkCoords + FIntPoint(OffsetX, OffsetY);
+            if ((OffsetX == 0 && OffsetY == 0) ||
+                Neighbour.X < 0 || Neighbour.Y < 0 || Neighbour.X >= NumChunks.X || Neighbour.Y >= NumChunks.Y)
+            {
+                continue;
+            }
+            MarkChunkDirty(Neighbour.X * NumChunks.Y + Neighbour.Y, true, false);
+        }
     }
+}
+
+// Uploads each dirty chunk once, sending only the streams that changed.
+void AProceduralTerrain::FlushDirtyChunks()
+{
+    if (ModificationBatchDepth > 0) return;
 
-    // Normalize each vertex normal to ensure proper lighting calculations
-    for (FVector& Normal : Normals)
+    static const TArray<FColor> UnchangedColors;
+
+    for (const int32 ChunkIndex : DirtyChunks)
     {
-        Normal.Normalize();
+        FChunkData& Chunk = Chunks[ChunkIndex];
+
+        if (Chunk.bGeometryDirty)
+        {
+            TArray<FVector> Normals;
+            TArray<FProcMeshTangent> Tangents;
+            CalculateNormalsAndTangents(FIntPoint(ChunkIndex / NumChunks.Y, ChunkIndex % NumChunks.Y), Chunk.Vertices,
+                                        [this](int32 GridX, int32 GridY) { return GetGridHeight(GridX, GridY); },
+                                        Normals, Tangents);
+            // Update the mesh section the new vertex positions, normals and tangents
+            ProceduralMesh->UpdateMeshSection(Chunk.SectionIndex, Chunk.Vertices, Normals, {},
+                                              Chunk.bLayersDirty ? Chunk.LayerWeights : UnchangedColors, Tangents);
+        }
+        else if (Chunk.bLayersDirty)
+        {
+            // Without positions the section keeps its geometry, bounds and collision untouched.
+            ProceduralMesh->UpdateMeshSection(Chunk.SectionIndex, {}, {}, {}, Chunk.LayerWeights, {});
+        }
+
+        Chunk.bGeometryDirty = false;
+        Chunk.bLayersDirty = false;
     }
+
+    DirtyChunks.Reset();
 }
 
 // Modifies the terrain at a specific location (e.g., "digging") by lowering vertex heights.
@@ -232,59 +564,215 @@ void AProceduralTerrain::ModifyTerrainAtLocation(const FVector& DigLocation, flo
     // Pre-calculate the squared radius
     const float DigRadiusSq = FMath::Square(DigRadius);
 
-    // Iterate through all terrain chunks.
-    // There are probably more optimized ways to check if the radius hits certain chunks,
-    // but I've already worked on this system for a tad too long than I probably should have.
-    for (FChunkData& Chunk : Chunks)
+    ForEachChunkInRadius(DigLocation, DigRadius, [&](int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)
     {
-        // AABB check: Expand chunk bounds by the dig radius and check if dig location is inside.
-        if (DigLocation.X < Chunk.MinBounds.X - DigRadius ||
-            DigLocation.X > Chunk.MaxBounds.X + DigRadius ||
-            DigLocation.Y < Chunk.MinBounds.Y - DigRadius ||
-            DigLocation.Y > Chunk.MaxBounds.Y + DigRadius)
+        FChunkData& Chunk = Chunks[ChunkIndex];
+
+        // Flag to indicate if any vertex has been modified (to update the mesh later)
+        bool bModified = false;
+        FIntPoint ModifiedMin = MaxVertex;
+        FIntPoint ModifiedMax = MinVertex;
+
+        for (int32 x = MinVertex.X; x <= MaxVertex.X; ++x)
         {
-            continue;
+            for (int32 y = MinVertex.Y; y <= MaxVertex.Y; ++y)
+            {
+                const int32 i = x * ChunkSize + y;
+
+                // Compute the squared distance from the vertex to the dig location
+                const float DistSq = FVector::DistSquared2D(Chunk.Vertices[i], DigLocation);
+
+                // If within the dig radius, modify the vertexs Z coordinate (height)
+                if (DistSq <= DigRadiusSq)
+                {
+                    const float Distance = FMath::Sqrt(DistSq);
+                    // Calculate influence: vertices closer to the center are modified more strongly
+                    const float Influence = FMath::Clamp(1.0f - (Distance / DigRadius), 0.0f, 1.0f);
+                    Chunk.Vertices[i].Z -= DigStrength * Influence;
+                    // Dug ground exposes dirt.
+                    BlendLayerWeight(Chunk.LayerWeights[i], ETerrainLayer::Dirt, DigDirtStrength * Influence);
+                    bModified = true;
+                    ModifiedMin = ModifiedMin.ComponentMin(FIntPoint(x, y));
+                    ModifiedMax = ModifiedMax.ComponentMax(FIntPoint(x, y));
+                }
+            }
         }
 
-        // Precise distance check: find the closest point in the chunk's bounds to the dig location
-        const float ClampedX = FMath::Clamp(DigLocation.X, Chunk.MinBounds.X, Chunk.MaxBounds.X);
-        const float ClampedY = FMath::Clamp(DigLocation.Y, Chunk.MinBounds.Y, Chunk.MaxBounds.Y);
-        const float DistanceSq = FVector::DistSquared2D(DigLocation, FVector(ClampedX, ClampedY, 0));
+        if (bModified)
+        {
+            MarkChunkDirty(ChunkIndex, true, true);
+            MarkNeighbourNormalsDirty(ChunkIndex, ModifiedMin, ModifiedMax);
 
-        if (DistanceSq > DigRadiusSq) continue;
+            // Keep the height pyramid in sync, touching only the dug rectangle.
+            HeightPyramid.UpdateChunkRegion(ChunkIndex, Chunk.Vertices, MinVertex, MaxVertex);
+        }
+    });
 
-        // Flag to indicate if any vertex has been modified (to update the mesh later)
+    // Recalculate normals and update each modified mesh section once.
+    FlushDirtyChunks();
+}
+
+// Carves a capsule around the segment out of the terrain, touching each chunk once.
+void AProceduralTerrain::ModifyTerrainAlongSegment(const FVector& Start, const FVector& End, float DigRadius, float DigStrength)
+{
+    if (DigRadius <= 0.0f) return;
+
+    const float DigRadiusSq = FMath::Square(DigRadius);
+    const FVector2D Start2D(Start);
+    const FVector2D Segment2D = FVector2D(End) - Start2D;
+    const float SegmentLengthSq = Segment2D.SizeSquared();
+
+    FBox2D Area(Start2D, Start2D);
+    Area += FVector2D(End);
+    Area = Area.ExpandBy(DigRadius);
+
+    ForEachChunkInArea(Area, [&](int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)
+    {
+        FChunkData& Chunk = Chunks[ChunkIndex];
         bool bModified = false;
-        // Reconstruct the chunk center from its bounds.
-        FVector ChunkCenter = FVector((Chunk.MinBounds.X + Chunk.MaxBounds.X) * 0.5f,
-                                      (Chunk.MinBounds.Y + Chunk.MaxBounds.Y) * 0.5f, 0);
+        FIntPoint ModifiedMin = MaxVertex;
+        FIntPoint ModifiedMax = MinVertex;
 
-        // Iterate through all vertices in the chunk
-        for (int32 i = 0; i < Chunk.Vertices.Num(); ++i)
+        for (int32 x = MinVertex.X; x <= MaxVertex.X; ++x)
         {
-            // Compute the squared distance from the vertex to the dig location
-            const float DistSq = FVector::DistSquared2D(Chunk.Vertices[i], DigLocation);
-
-            // If within the dig radius, modify the vertexs Z coordinate (height)
-            if (DistSq <= DigRadiusSq)
+            for (int32 y = MinVertex.Y; y <= MaxVertex.Y; ++y)
             {
-                const float Distance = FMath::Sqrt(DistSq);
-                // Calculate influence: vertices closer to the center are modified more strongly
-                const float Influence = FMath::Clamp(1.0f - (Distance / DigRadius), 0.0f, 1.0f);
-                Chunk.Vertices[i].Z -= DigStrength * Influence;
+                const int32 i = x * ChunkSize + y;
+                FVector& Vertex = Chunk.Vertices[i];
+
+                // Closest point of the segment in XY; a vertical segment reaches down to its lower end.
+                const float T = SegmentLengthSq > UE_KINDA_SMALL_NUMBER
+                    ? FMath::Clamp(FVector2D::DotProduct(FVector2D(Vertex) - Start2D, Segment2D) / SegmentLengthSq, 0.0f, 1.0f)
+                    : (End.Z < Start.Z ? 1.0f : 0.0f);
+                const FVector Closest = FMath::Lerp(Start, End, T);
+
+                const float DistSq = FVector::DistSquared2D(Vertex, Closest);
+                if (DistSq > DigRadiusSq) continue;
+
+                // Lower the vertex to the bottom of the capsule, limited by the dig strength.
+                const float Bottom = Closest.Z - FMath::Sqrt(DigRadiusSq - DistSq);
+                const float NewZ = FMath::Max(FMath::Min(Vertex.Z, Bottom), Vertex.Z - DigStrength);
+                if (NewZ >= Vertex.Z) continue;
+
+                Vertex.Z = NewZ;
+                // Dug ground exposes dirt.
+                const float Influence = FMath::Clamp(1.0f - (FMath::Sqrt(DistSq) / DigRadius), 0.0f, 1.0f);
+                BlendLayerWeight(Chunk.LayerWeights[i], ETerrainLayer::Dirt, DigDirtStrength * Influence);
                 bModified = true;
+                ModifiedMin = ModifiedMin.ComponentMin(FIntPoint(x, y));
+                ModifiedMax = ModifiedMax.ComponentMax(FIntPoint(x, y));
             }
         }
 
-        // If any vertices were modified, recalculate normals and update the mesh section.
         if (bModified)
         {
-            TArray<FVector> Normals;
-            CalculateNormals(Chunk.Vertices, Chunk.Triangles, Normals);
-            // Update the mesh section the new vertex positions and normals
-            ProceduralMesh->UpdateMeshSection_LinearColor(Chunk.SectionIndex,
-                                                          Chunk.Vertices,
-                                                          Normals, {}, {}, {});
+            MarkChunkDirty(ChunkIndex, true, true);
+            MarkNeighbourNormalsDirty(ChunkIndex, ModifiedMin, ModifiedMax);
+            HeightPyramid.UpdateChunkRegion(ChunkIndex, Chunk.Vertices, MinVertex, MaxVertex);
+        }
+    });
+
+    FlushDirtyChunks();
+}
+
+// Blends a material layer into the vertex weights around a location; only layer colors are re-uploaded.
+void AProceduralTerrain::PaintTerrainLayerAtLocation(const FVector& Location, ETerrainLayer Layer, float Radius, float Strength)
+{
+    const float RadiusSq = FMath::Square(Radius);
+
+    ForEachChunkInRadius(Location, Radius, [&](int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)
+    {
+        FChunkData& Chunk = Chunks[ChunkIndex];
+        bool bModified = false;
+
+        for (int32 x = MinVertex.X; x <= MaxVertex.X; ++x)
+        {
+            for (int32 y = MinVertex.Y; y <= MaxVertex.Y; ++y)
+            {
+                const int32 i = x * ChunkSize + y;
+                const float DistSq = FVector::DistSquared2D(Chunk.Vertices[i], Location);
+
+                if (DistSq <= RadiusSq)
+                {
+                    const float Influence = FMath::Clamp(1.0f - (FMath::Sqrt(DistSq) / Radius), 0.0f, 1.0f);
+                    BlendLayerWeight(Chunk.LayerWeights[i], Layer, Strength * Influence);
+                    bModified = true;
+                }
+            }
+        }
+
+        if (bModified)
+        {
+            MarkChunkDirty(ChunkIndex, false, true);
+        }
+    });
+
+    FlushDirtyChunks();
+}
+
+void AProceduralTerrain::BeginModificationBatch()
+{
+    ModificationBatchDepth++;
+}
+
+void AProceduralTerrain::EndModificationBatch()
+{
+    check(ModificationBatchDepth > 0);
+    if (--ModificationBatchDepth == 0)
+    {
+        FlushDirtyChunks();
+    }
+}
+
+/// | Terrain Queries | ///
+
+bool AProceduralTerrain::GetTerrainHeightAtLocation(const FVector& Location, float& OutHeight) const
+{
+    const FTransform& ActorTransform = GetActorTransform();
+    const FVector LocalLocation = ActorTransform.InverseTransformPosition(Location);
+
+    float LocalHeight;
+    if (!HeightPyramid.GetHeightAt(FVector2D(LocalLocation), LocalHeight)) return false;
+
+    OutHeight = ActorTransform.TransformPosition(FVector(LocalLocation.X, LocalLocation.Y, LocalHeight)).Z;
+    return true;
+}
+
+bool AProceduralTerrain::RaycastTerrain(const FVector& Start, const FVector& End, FVector& OutHitLocation, FVector& OutHitNormal) const
+{
+    const FTransform& ActorTransform = GetActorTransform();
+
+    FVector LocalHit, LocalNormal;
+    if (!HeightPyramid.Raycast(ActorTransform.InverseTransformPosition(Start),
+                               ActorTransform.InverseTransformPosition(End),
+                               LocalHit, LocalNormal))
+    {
+        return false;
+    }
+
+    OutHitLocation = ActorTransform.TransformPosition(LocalHit);
+    OutHitNormal = ActorTransform.TransformVectorNoScale(LocalNormal);
+    return true;
+}
+
+bool AProceduralTerrain::TerrainOverlapsSphere(const FVector& Center, float Radius) const
+{
+    const FTransform& ActorTransform = GetActorTransform();
+    return HeightPyramid.OverlapSphere(ActorTransform.InverseTransformPosition(Center),
+                                       Radius / ActorTransform.GetMaximumAxisScale());
+}
+
+void AProceduralTerrain::GetVisibleChunkSections(const FConvexVolume& ViewFrustum, TArray<int32>& OutSectionIndices) const
+{
+    TArray<int32> ChunkIndices;
+    HeightPyramid.GetChunksInFrustum(ViewFrustum, GetActorTransform(), ChunkIndices);
+
+    OutSectionIndices.Reserve(OutSectionIndices.Num() + ChunkIndices.Num());
+    for (const int32 ChunkIndex : ChunkIndices)
+    {
+        if (Chunks.IsValidIndex(ChunkIndex))
+        {
+            OutSectionIndices.Add(Chunks[ChunkIndex].SectionIndex);
         }
     }
 }
@@ -0,0 +1,176 @@
+#include "SplatCoverageIndex.h"
+
+void FSplatCoverageIndex::Init(float InCellSize)
+{
+    CellSize = FMath::Max(InCellSize, 1.0f);
+    Cells.Reset();
+    TeamCells.Reset();
+    SurfaceTeamCells.Reset();
+    NumPaintedCells = 0;
+}
+
+FIntVector FSplatCoverageIndex::GetCellCoord(const FVector& Location) const
+{
+    return FIntVector(
+        FMath::FloorToInt32(Location.X / CellSize),
+        FMath::FloorToInt32(Location.Y / CellSize),
+        FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+int32 FSplatCoverageIndex::AddHit(const FObjectKey& Surface, const FVector& Location, const FVector& Normal, float Radius, int32 TeamIndex)
+{
+    if (!IsInitialized() || TeamIndex < 0 || TeamIndex > MaxTeams) return 0;
+
+    // Sample the disc at half a cell so no cell it crosses is skipped. Cells sampled twice by the
+    // same hit already belong to the team and do not count again.
+    FVector AxisU, AxisV;
+    const FVector SafeNormal = Normal.GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+    SafeNormal.FindBestAxisVectors(AxisU, AxisV);
+
+    const float Step = CellSize * 0.5f;
+    const int32 NumSteps = FMath::CeilToInt32(Radius / Step);
+    const float RadiusSquared = FMath::Square(Radius);
+
+    int32 NumChanged = 0;
+    for (int32 U = -NumSteps; U <= NumSteps; U++)
+    {
+        for (int32 V = -NumSteps; V <= NumSteps; V++)
+        {
+            const float OffsetU = U * Step;
+            const float OffsetV = V * Step;
+            if (FMath::Square(OffsetU) + FMath::Square(OffsetV) > RadiusSquared) continue;
+
+            const FVector Sample = Location + AxisU * OffsetU + AxisV * OffsetV;
+            if (PaintCell(GetCellCoord(Sample), Surface, uint8(TeamIndex)))
+            {
+                NumChanged++;
+            }
+        }
+    }
+    return NumChanged;
+}
+
+bool FSplatCoverageIndex::PaintCell(const FIntVector& Coord, const FObjectKey& Surface, uint8 TeamIndex)
+{
+    FCell& Cell = Cells.FindOrAdd(Coord);
+
+    FCellEntry* Entry = Cell.FindByPredicate([&Surface](const FCellEntry& Existing) { return Existing.Surface == Surface; });
+    if (Entry && Entry->TeamIndex == TeamIndex) return false;
+
+    TArray<int32>& SurfaceCells = SurfaceTeamCells.FindOrAdd(Surface);
+    if (Entry)
+    {
+        // Repainted by another team: move the cell between the totals.
+        AddTeamCells(TeamCells, Entry->TeamIndex, -1);
+        AddTeamCells(SurfaceCells, Entry->TeamIndex, -1);
+        Entry->TeamIndex = TeamIndex;
+    }
+    else
+    {
+        Cell.Add({ Surface, TeamIndex });
+        NumPaintedCells++;
+    }
+
+    AddTeamCells(TeamCells, TeamIndex, 1);
+    AddTeamCells(SurfaceCells, TeamIndex, 1);
+    return true;
+}
+
+void FSplatCoverageIndex::AddTeamCells(TArray<int32>& Counts, int32 TeamIndex, int32 Delta)
+{
+    if (!Counts.IsValidIndex(TeamIndex))
+    {
+        Counts.SetNumZeroed(TeamIndex + 1);
+    }
+    Counts[TeamIndex] += Delta;
+}
+
+void FSplatCoverageIndex::CellsToArea(const TArray<int32>& Counts, TArray<float>& OutAreaPerTeam) const
+{
+    const float CellArea = FMath::Square(CellSize);
+    OutAreaPerTeam.SetNumUninitialized(Counts.Num());
+    for (int32 Team = 0; Team < Counts.Num(); Team++)
+    {
+        OutAreaPerTeam[Team] = Counts[Team] * CellArea;
+    }
+}
+
+float FSplatCoverageIndex::GetTeamArea(int32 TeamIndex) const
+{
+    return TeamCells.IsValidIndex(TeamIndex) ? TeamCells[TeamIndex] * FMath::Square(CellSize) : 0.0f;
+}
+
+void FSplatCoverageIndex::GetSurfaceCoverage(const FObjectKey& Surface, TArray<float>& OutAreaPerTeam) const
+{
+    OutAreaPerTeam.Reset();
+    if (const TArray<int32>* SurfaceCells = SurfaceTeamCells.Find(Surface))
+    {
+        CellsToArea(*SurfaceCells, OutAreaPerTeam);
+    }
+}
+
+void FSplatCoverageIndex::GetRegionCoverage(const FBox& Region, TArray<float>& OutAreaPerTeam) const
+{
+    OutAreaPerTeam.Reset();
+    if (!IsInitialized() || !Region.IsValid || Cells.IsEmpty()) return;
+
+    const FIntVector MinCoord = GetCellCoord(Region.Min);
+    const FIntVector MaxCoord = GetCellCoord(Region.Max);
+    const int64 RegionCells = int64(MaxCoord.X - MinCoord.X + 1) * (MaxCoord.Y - MinCoord.Y + 1) * (MaxCoord.Z - MinCoord.Z + 1);
+
+    TArray<int32> Counts;
+    auto CountCell = [&Counts](const FCell& Cell)
+    {
+        for (const FCellEntry& Entry : Cell)
+        {
+            AddTeamCells(Counts, Entry.TeamIndex, 1);
+        }
+    };
+
+    // Walk whichever is smaller: the cells inside the region or the painted cells.
+    if (RegionCells <= Cells.Num())
+    {
+        for (int32 X = MinCoord.X; X <= MaxCoord.X; X++)
+        {
+            for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; Y++)
+            {
+                for (int32 Z = MinCoord.Z; Z <= MaxCoord.Z; Z++)
+                {
+                    if (const FCell* Cell = Cells.Find(FIntVector(X, Y, Z)))
+                    {
+                        CountCell(*Cell);
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        for (const TPair<FIntVector, FCell>& Pair : Cells)
+        {
+            const FIntVector& Coord = Pair.Key;
+            if (Coord.X >= MinCoord.X && Coord.X <= MaxCoord.X &&
+                Coord.Y >= MinCoord.Y && Coord.Y <= MaxCoord.Y &&
+                Coord.Z >= MinCoord.Z && Coord.Z <= MaxCoord.Z)
+            {
+                CountCell(Pair.Value);
+            }
+        }
+    }
+
+    CellsToArea(Counts, OutAreaPerTeam);
+}
+
+SIZE_T FSplatCoverageIndex::GetAllocatedSize() const
+{
+    SIZE_T Size = Cells.GetAllocatedSize() + TeamCells.GetAllocatedSize() + SurfaceTeamCells.GetAllocatedSize();
+    for (const TPair<FIntVector, FCell>& Pair : Cells)
+    {
+        Size += Pair.Value.GetAllocatedSize();
+    }
+    for (const TPair<FObjectKey, TArray<int32>>& Pair : SurfaceTeamCells)
+    {
+        Size += Pair.Value.GetAllocatedSize();
+    }
+    return Size;
+}
@@ -0,0 +1,161 @@
+#include "SplatCoverageSubsystem.h"
+#include "GAM415Project.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+static TAutoConsoleVariable<float> CVarSplatCoverageCellSize(
+    TEXT("Splat.CoverageCellSize"),
+    50.0f,
+    TEXT("Edge length of the cells splat coverage is counted in. Applies to worlds started afterwards."));
+
+bool USplatCoverageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USplatCoverageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+    Index.Init(CVarSplatCoverageCellSize.GetValueOnGameThread());
+}
+
+void USplatCoverageSubsystem::AddHit(const AActor* Surface, const FVector& Location, const FVector& Normal, float Radius,
+                                     int32 TeamIndex)
+{
+    if (TeamIndex < 0 || TeamIndex > FSplatCoverageIndex::MaxTeams) return;
+
+    Index.AddHit(FObjectKey(Surface), Location, Normal, Radius, TeamIndex);
+}
+
+int32 USplatCoverageSubsystem::GetShooterTeam(const AActor* Shooter)
+{
+    const FObjectKey Key(Shooter);
+    if (const int32* Existing = ShooterTeams.Find(Key))
+    {
+        return *Existing;
+    }
+
+    if (NumTeams > FSplatCoverageIndex::MaxTeams)
+    {
+        UE_LOG(LogGAM415Project, Warning, TEXT("Splat coverage has no room for another team, %s's paint is not recorded"),
+               *GetNameSafe(Shooter));
+        return INDEX_NONE;
+    }
+    return ShooterTeams.Add(Key, NumTeams++);
+}
+
+void USplatCoverageSubsystem::SetShooterTeam(const AActor* Shooter, int32 TeamIndex)
+{
+    if (TeamIndex < 0 || TeamIndex > FSplatCoverageIndex::MaxTeams)
+    {
+        UE_LOG(LogGAM415Project, Warning, TEXT("Splat coverage team %d is out of range"), TeamIndex);
+        return;
+    }
+    ShooterTeams.Add(FObjectKey(Shooter), TeamIndex);
+    NumTeams = FMath::Max(NumTeams, TeamIndex + 1);
+}
+
+float USplatCoverageSubsystem::GetTeamArea(int32 TeamIndex) const
+{
+    return Index.GetTeamArea(TeamIndex);
+}
+
+void USplatCoverageSubsystem::GetSurfaceCoverage(const AActor* Surface, TArray<float>& OutAreaPerTeam) const
+{
+    Index.GetSurfaceCoverage(FObjectKey(Surface), OutAreaPerTeam);
+}
+
+void USplatCoverageSubsystem::GetRegionCoverage(const FBox& Region, TArray<float>& OutAreaPerTeam) const
+{
+    Index.GetRegionCoverage(Region, OutAreaPerTeam);
+}
+
+void USplatCoverageSubsystem::ResetCoverage()
+{
+    Index.Init(Index.GetCellSize());
+}
+
+/// | Benchmark | ///
+
+// Fills a private coverage index with random hits over a level-sized area and logs the hit rate,
+// then the latency of team, surface and region queries against it. Live coverage is untouched.
+// Usage: Splat.BenchmarkCoverage [Hits=200000] [Queries=1000] [Teams=4]
+static void RunSplatCoverageBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    const int32 NumHits = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 200000;
+    const int32 NumQueries = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 1000;
+    const int32 NumTeams = Args.Num() > 2 ? FMath::Clamp(FCString::Atoi(*Args[2]), 1, FSplatCoverageIndex::MaxTeams) : 4;
+
+    // Spread the hits over a few real actors so per-surface totals are exercised.
+    TArray<FObjectKey, TInlineAllocator<16>> Surfaces;
+    if (World)
+    {
+        for (TActorIterator<AActor> It(World); It && Surfaces.Num() < 16; ++It)
+        {
+            Surfaces.Add(FObjectKey(*It));
+        }
+    }
+    if (Surfaces.IsEmpty())
+    {
+        Surfaces.Add(FObjectKey());
+    }
+
+    const float Extent = 20000.0f;
+    const float Radius = 64.0f;
+    FRandomStream Random(415);
+
+    FSplatCoverageIndex Coverage;
+    Coverage.Init(CVarSplatCoverageCellSize.GetValueOnGameThread());
+
+    // Hits land on flat ground or on walls facing along X, as in the level.
+    double StartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < NumHits; i++)
+    {
+        const FVector Location(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), Random.FRandRange(0.0f, 1000.0f));
+        const FVector Normal = Random.FRand() < 0.7f ? FVector::UpVector : FVector::ForwardVector;
+        Coverage.AddHit(Surfaces[Random.RandHelper(Surfaces.Num())], Location, Normal, Radius, Random.RandHelper(NumTeams));
+    }
+    const double HitSeconds = FMath::Max(FPlatformTime::Seconds() - StartTime, 1e-6);
+
+    TArray<float> Areas;
+    float Checksum = 0.0f;
+
+    StartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < NumQueries; i++)
+    {
+        Checksum += Coverage.GetTeamArea(i % NumTeams);
+    }
+    const double TeamSeconds = FPlatformTime::Seconds() - StartTime;
+
+    StartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < NumQueries; i++)
+    {
+        Coverage.GetSurfaceCoverage(Surfaces[i % Surfaces.Num()], Areas);
+        Checksum += Areas.IsEmpty() ? 0.0f : Areas[0];
+    }
+    const double SurfaceSeconds = FPlatformTime::Seconds() - StartTime;
+
+    // Regions the size of a capture zone: 1000 units wide and covering the full height range.
+    StartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < NumQueries; i++)
+    {
+        const FVector Center(Random.FRandRange(-Extent, Extent), Random.FRandRange(-Extent, Extent), 500.0f);
+        Coverage.GetRegionCoverage(FBox::BuildAABB(Center, FVector(500.0f)), Areas);
+        Checksum += Areas.IsEmpty() ? 0.0f : Areas[0];
+    }
+    const double RegionSeconds = FPlatformTime::Seconds() - StartTime;
+
+    UE_LOG(LogGAM415Project, Display,
+           TEXT("Splat coverage benchmark, %d hits: %.1f ms (%.0f hits/s), %d cells, %.1f MB"),
+           NumHits, HitSeconds * 1000.0, NumHits / HitSeconds, Coverage.GetNumPaintedCells(),
+           Coverage.GetAllocatedSize() / (1024.0 * 1024.0));
+    UE_LOG(LogGAM415Project, Display,
+           TEXT("Splat coverage benchmark, %d queries: team %.3f us, surface %.3f us, region %.1f us (checksum %.0f)"),
+           NumQueries, TeamSeconds * 1e6 / NumQueries, SurfaceSeconds * 1e6 / NumQueries,
+           RegionSeconds * 1e6 / NumQueries, Checksum);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GSplatCoverageBenchmarkCommand(
+    TEXT("Splat.BenchmarkCoverage"),
+    TEXT("Records random splat hits into a private coverage index and logs hits/second and the latency of team, surface and region coverage queries. Args: [Hits=200000] [Queries=1000] [Teams=4]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunSplatCoverageBenchmark));
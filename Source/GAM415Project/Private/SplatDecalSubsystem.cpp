@@ -0,0 +1,238 @@
+#include "SplatDecalSubsystem.h"
+#include "Components/DecalComponent.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+static TAutoConsoleVariable<int32> CVarSplatDecalBudget(
+    TEXT("Splat.DecalBudget"),
+    128,
+    TEXT("Maximum number of splat decals alive at once; new splats recycle the oldest beyond it."));
+
+static TAutoConsoleVariable<float> CVarSplatDecalMergeDistance(
+    TEXT("Splat.DecalMergeDistance"),
+    0.25f,
+    TEXT("Splats closer than this fraction of their size to a live splat on the same surface refresh it instead of adding a decal. 0 disables merging."));
+
+bool USplatDecalSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USplatDecalSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(USplatDecalSubsystem, STATGROUP_Tickables);
+}
+
+// Hides splats whose lifetime ran out, freeing their slots for reuse.
+void USplatDecalSubsystem::Tick(float DeltaTime)
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+    for (int32 i = 0; i < Slots.Num(); i++)
+    {
+        FSplatDecalSlot& Slot = Slots[i];
+        if (Slot.bActive && Slot.ExpireTime > 0.0 && Now >= Slot.ExpireTime)
+        {
+            Slot.bActive = false;
+            if (IsValid(Slot.Decal))
+            {
+                Slot.Decal->SetVisibility(false);
+            }
+            FreeSlots.Add(i);
+        }
+    }
+}
+
+int32 USplatDecalSubsystem::GetNumActiveDecals() const
+{
+    int32 Num = 0;
+    for (const FSplatDecalSlot& Slot : Slots)
+    {
+        Num += Slot.bActive ? 1 : 0;
+    }
+    return Num;
+}
+
+void USplatDecalSubsystem::AddSplat(const FHitResult& Hit, const FSplatDecalParams& Params)
+{
+    if (!Params.Material) return;
+
+    const int32 Budget = FMath::Max(CVarSplatDecalBudget.GetValueOnGameThread(), 1);
+    TrimToBudget(Budget);
+
+    const FVector Location = Hit.ImpactPoint;
+    const FVector Normal = Hit.ImpactNormal;
+
+    int32 SlotIndex = FindMergeSlot(Location, Normal, Params.Size);
+    if (SlotIndex == INDEX_NONE)
+    {
+        SlotIndex = AllocateSlot();
+    }
+    if (SlotIndex == INDEX_NONE) return;
+
+    ShowSplat(Slots[SlotIndex], Location, Normal.Rotation(), Params);
+}
+
+int32 USplatDecalSubsystem::FindMergeSlot(const FVector& Location, const FVector& Normal, float Size) const
+{
+    const float MergeDistance = Size * CVarSplatDecalMergeDistance.GetValueOnGameThread();
+    if (MergeDistance <= 0.0f) return INDEX_NONE;
+
+    const float MergeDistanceSq = FMath::Square(MergeDistance);
+    for (int32 i = 0; i < Slots.Num(); i++)
+    {
+        const FSplatDecalSlot& Slot = Slots[i];
+        if (!Slot.bActive || Slot.Size < Size * 0.5f) continue;
+
+        // Same spot on the same surface: a small distance and a similar facing.
+        if (FVector::DistSquared(Slot.Decal->GetComponentLocation(), Location) <= MergeDistanceSq &&
+            FVector::DotProduct(Slot.Decal->GetForwardVector(), Normal) > 0.9f)
+        {
+            return i;
+        }
+    }
+    return INDEX_NONE;
+}
+
+int32 USplatDecalSubsystem::AllocateSlot()
+{
+    const int32 Budget = FMath::Max(CVarSplatDecalBudget.GetValueOnGameThread(), 1);
+
+    int32 SlotIndex = INDEX_NONE;
+
+    // Expired slots first; entries for slots trimmed or reused since are skipped.
+    while (SlotIndex == INDEX_NONE && !FreeSlots.IsEmpty())
+    {
+        const int32 Index = FreeSlots.Pop(EAllowShrinking::No);
+        if (Slots.IsValidIndex(Index) && !Slots[Index].bActive)
+        {
+            SlotIndex = Index;
+        }
+    }
+
+    // Under budget: create another decal component.
+    if (SlotIndex == INDEX_NONE && Slots.Num() < Budget)
+    {
+        SlotIndex = Slots.AddDefaulted();
+    }
+
+    // At budget: recycle the splat placed or merged into longest ago. Merged and reused slots are
+    // queued again, so their older entries no longer match the slot's Serial.
+    while (SlotIndex == INDEX_NONE && RecycleHead < RecycleQueue.Num())
+    {
+        const FSplatDecalRecycleEntry& Entry = RecycleQueue[RecycleHead++];
+        if (Slots.IsValidIndex(Entry.SlotIndex) && Slots[Entry.SlotIndex].bActive && Slots[Entry.SlotIndex].Serial == Entry.Serial)
+        {
+            SlotIndex = Entry.SlotIndex;
+        }
+    }
+    if (SlotIndex == INDEX_NONE) return INDEX_NONE;
+
+    if (!IsValid(Slots[SlotIndex].Decal))
+    {
+        CreateDecal(Slots[SlotIndex]);
+    }
+    return SlotIndex;
+}
+
+void USplatDecalSubsystem::CreateDecal(FSplatDecalSlot& Slot)
+{
+    if (!DecalActor)
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.ObjectFlags |= RF_Transient;
+        DecalActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+        DecalActor->SetRootComponent(NewObject<USceneComponent>(DecalActor, TEXT("Root")));
+        DecalActor->GetRootComponent()->RegisterComponent();
+    }
+
+    Slot.Decal = NewObject<UDecalComponent>(DecalActor);
+    Slot.Decal->SetupAttachment(DecalActor->GetRootComponent());
+    Slot.Decal->SetUsingAbsoluteLocation(true);
+    Slot.Decal->SetUsingAbsoluteRotation(true);
+    Slot.Decal->RegisterComponent();
+    Slot.MaterialInstance = nullptr;
+}
+
+void USplatDecalSubsystem::ShowSplat(FSplatDecalSlot& Slot, const FVector& Location, const FRotator& Rotation,
+                                     const FSplatDecalParams& Params)
+{
+    UDecalComponent* Decal = Slot.Decal;
+    Decal->SetWorldLocationAndRotation(Location, Rotation);
+    Decal->DecalSize = FVector(Params.Size);
+
+    if (Params.Variant != INDEX_NONE)
+    {
+        // Shared material: color and texture slice travel in the decal color, so decals batch
+        // and no dynamic material instance is needed.
+        if (Decal->GetDecalMaterial() != Params.Material)
+        {
+            Decal->SetDecalMaterial(Params.Material);
+            Slot.MaterialInstance = nullptr;
+        }
+        Decal->SetDecalColor(FLinearColor(Params.Color.R, Params.Color.G, Params.Color.B, Params.Variant / 255.0f));
+    }
+    else
+    {
+        // Configure decal material; the dynamic instance is created once per slot.
+        if (!Slot.MaterialInstance || Slot.MaterialInstance->Parent != Params.Material)
+        {
+            Decal->SetDecalMaterial(Params.Material);
+            Slot.MaterialInstance = Decal->CreateDynamicMaterialInstance();
+        }
+        if (Slot.MaterialInstance)
+        {
+            Slot.MaterialInstance->SetTextureParameterValue("Texture", Params.Texture);
+            Slot.MaterialInstance->SetVectorParameterValue("Color", Params.Color);
+        }
+    }
+
+    // For fade effect in decal material. Restarting the fade also recreates the render state.
+    // SetFadeOut also starts a life span timer that destroys the component whatever its flag says,
+    // so it is cleared again; Tick hides the slot once its lifetime runs out.
+    if (Params.Lifetime != 0)
+        Decal->SetFadeOut(Params.Lifetime - Params.FadeOutLength, Params.FadeOutLength, false);
+    else
+        Decal->SetFadeOut(0.0f, 0.0f, false);
+    Decal->SetLifeSpan(0.0f);
+
+    Decal->SetVisibility(true);
+    Decal->MarkRenderStateDirty();
+
+    Slot.StartTime = GetWorld()->GetTimeSeconds();
+    Slot.ExpireTime = Params.Lifetime > 0.0f ? Slot.StartTime + Params.Lifetime : 0.0;
+    Slot.Size = Params.Size;
+    Slot.bActive = true;
+    Slot.Serial++;
+
+    RecycleQueue.Add({ int32(&Slot - Slots.GetData()), Slot.Serial });
+
+    // Consumed entries are dropped once they make up half the queue, and stale ones once merges
+    // have grown it well past the pool, so the queue costs constant time per splat on average.
+    if (RecycleHead > RecycleQueue.Num() / 2)
+    {
+        RecycleQueue.RemoveAt(0, RecycleHead, EAllowShrinking::No);
+        RecycleHead = 0;
+    }
+    if (RecycleQueue.Num() > Slots.Num() * 4 + 16)
+    {
+        RecycleQueue.RemoveAll([this](const FSplatDecalRecycleEntry& Entry)
+        {
+            return !Slots.IsValidIndex(Entry.SlotIndex) || !Slots[Entry.SlotIndex].bActive || Slots[Entry.SlotIndex].Serial != Entry.Serial;
+        });
+        RecycleHead = 0;
+    }
+}
+
+void USplatDecalSubsystem::TrimToBudget(int32 Budget)
+{
+    if (Slots.Num() <= Budget) return;
+
+    for (int32 i = Budget; i < Slots.Num(); i++)
+    {
+        if (Slots[i].Decal)
+        {
+            Slots[i].Decal->DestroyComponent();
+        }
+    }
+    Slots.SetNum(Budget);
+}
@@ -0,0 +1,206 @@
+#include "SplatEffectSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "NiagaraComponent.h"
+#include "NiagaraDataInterfaceArrayFunctionLibrary.h"
+#include "NiagaraFunctionLibrary.h"
+
+static TAutoConsoleVariable<int32> CVarSplatEffectBudget(
+    TEXT("Splat.EffectBudget"),
+    16,
+    TEXT("Maximum number of splat Niagara systems spawned per frame; the impacts nearest to a player win."));
+
+static TAutoConsoleVariable<float> CVarSplatEffectCullDistance(
+    TEXT("Splat.EffectCullDistance"),
+    5000.0f,
+    TEXT("Splat impacts farther than this from every local player's view spawn no effect. 0 disables culling."));
+
+static TAutoConsoleVariable<int32> CVarSplatEffectMaxAggregated(
+    TEXT("Splat.EffectMaxAggregated"),
+    64,
+    TEXT("Maximum number of impacts merged into one aggregate splat effect."));
+
+bool USplatEffectSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USplatEffectSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(USplatEffectSubsystem, STATGROUP_Tickables);
+}
+
+void USplatEffectSubsystem::AddImpact(const FSplatEffectRequest& Request)
+{
+    if (!Request.System && !Request.AggregateSystem) return;
+
+    // Dedicated servers never show effects.
+    if (GetWorld()->GetNetMode() == NM_DedicatedServer) return;
+
+    PendingImpacts.Add(Request);
+}
+
+void USplatEffectSubsystem::Tick(float DeltaTime)
+{
+    if (PendingImpacts.IsEmpty()) return;
+
+    UWorld* World = GetWorld();
+
+    // Gather every local player's view to measure impact distances against.
+    TArray<FVector, TInlineAllocator<4>> ViewLocations;
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (PlayerController && PlayerController->IsLocalController())
+        {
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            ViewLocations.Add(ViewLocation);
+        }
+    }
+
+    const float CullDistance = CVarSplatEffectCullDistance.GetValueOnGameThread();
+    auto GetViewDistanceSq = [&ViewLocations](const FVector& Location)
+    {
+        float MinDistanceSq = ViewLocations.IsEmpty() ? 0.0f : TNumericLimits<float>::Max();
+        for (const FVector& ViewLocation : ViewLocations)
+        {
+            MinDistanceSq = FMath::Min(MinDistanceSq, float(FVector::DistSquared(ViewLocation, Location)));
+        }
+        return MinDistanceSq;
+    };
+
+    // Drop distant impacts and order the rest nearest first.
+    TArray<TPair<float, const FSplatEffectRequest*>> Impacts;
+    Impacts.Reserve(PendingImpacts.Num());
+    for (const FSplatEffectRequest& Request : PendingImpacts)
+    {
+        const float DistanceSq = GetViewDistanceSq(Request.Location);
+        if (CullDistance > 0.0f && DistanceSq > FMath::Square(CullDistance))
+        {
+            NumCulled++;
+            continue;
+        }
+        Impacts.Emplace(DistanceSq, &Request);
+    }
+    Impacts.Sort([](const TPair<float, const FSplatEffectRequest*>& A, const TPair<float, const FSplatEffectRequest*>& B)
+    {
+        return A.Key < B.Key;
+    });
+
+    int32 Budget = FMath::Max(CVarSplatEffectBudget.GetValueOnGameThread(), 0);
+    const int32 MaxAggregated = FMath::Max(CVarSplatEffectMaxAggregated.GetValueOnGameThread(), 1);
+
+    // Merge impacts that share an aggregate system. Impacts arrive nearest first, so single impacts
+    // and groups are queued for spawning by their nearest impact; a group is queued through its first member.
+    TMap<UNiagaraSystem*, TArray<const FSplatEffectRequest*>> Aggregated;
+    TArray<const FSplatEffectRequest*> Spawns;
+    Spawns.Reserve(Impacts.Num());
+    for (const TPair<float, const FSplatEffectRequest*>& Impact : Impacts)
+    {
+        const FSplatEffectRequest* Request = Impact.Value;
+        if (!Request->AggregateSystem)
+        {
+            Spawns.Add(Request);
+            continue;
+        }
+
+        TArray<const FSplatEffectRequest*>& Group = Aggregated.FindOrAdd(Request->AggregateSystem);
+        if (Group.IsEmpty())
+        {
+            Spawns.Add(Request);
+        }
+        if (Group.Num() < MaxAggregated)
+        {
+            Group.Add(Request);
+        }
+        else
+        {
+            NumCulled++;
+        }
+    }
+
+    // Spend the budget in one pass, nearest first; each spawn costs one budget slot.
+    for (const FSplatEffectRequest* Request : Spawns)
+    {
+        const TArray<const FSplatEffectRequest*>* Group = Request->AggregateSystem ? Aggregated.Find(Request->AggregateSystem) : nullptr;
+        if (Budget > 0)
+        {
+            if (Group)
+            {
+                SpawnAggregate(Request->AggregateSystem, *Group);
+            }
+            else
+            {
+                SpawnSingle(*Request);
+            }
+            Budget--;
+        }
+        else
+        {
+            NumCulled += Group ? Group->Num() : 1;
+        }
+    }
+
+    PendingImpacts.Reset();
+}
+
+void USplatEffectSubsystem::SpawnSingle(const FSplatEffectRequest& Request)
+{
+    // Pooled components return to the world's Niagara pool when the effect completes.
+    UNiagaraComponent* NiagaraComp = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+        GetWorld(),
+        Request.System,
+        Request.Location,
+        Request.Normal.Rotation(),
+        FVector::OneVector,
+        false,
+        true,
+        ENCPoolMethod::AutoRelease
+    );
+
+    if (!NiagaraComp) return;
+    NumSpawned++;
+
+    // Set color parameter
+    NiagaraComp->SetVariableLinearColor("Color", Request.Color);
+}
+
+void USplatEffectSubsystem::SpawnAggregate(UNiagaraSystem* System, TConstArrayView<const FSplatEffectRequest*> Requests)
+{
+    if (Requests.IsEmpty()) return;
+
+    // The system is placed at the first (nearest) impact; the bursts use absolute positions.
+    UNiagaraComponent* NiagaraComp = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+        GetWorld(),
+        System,
+        Requests[0]->Location,
+        FRotator::ZeroRotator,
+        FVector::OneVector,
+        false,
+        true,
+        ENCPoolMethod::AutoRelease
+    );
+
+    if (!NiagaraComp) return;
+    NumSpawned++;
+
+    TArray<FVector> Positions;
+    TArray<FVector> Normals;
+    TArray<FLinearColor> Colors;
+    Positions.Reserve(Requests.Num());
+    Normals.Reserve(Requests.Num());
+    Colors.Reserve(Requests.Num());
+    for (const FSplatEffectRequest* Request : Requests)
+    {
+        Positions.Add(Request->Location);
+        Normals.Add(Request->Normal);
+        Colors.Add(Request->Color);
+    }
+
+    UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayPosition(NiagaraComp, "ImpactPositions", Positions);
+    UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(NiagaraComp, "ImpactNormals", Normals);
+    UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayColor(NiagaraComp, "ImpactColors", Colors);
+    NiagaraComp->SetVariableInt("ImpactCount", Requests.Num());
+}
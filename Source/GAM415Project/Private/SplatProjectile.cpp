@@ -1,9 +1,14 @@
 #include "SplatProjectile.h"
+#include "ProceduralTerrain.h"
+#include "SplatCoverageSubsystem.h"
+#include "SplatDecalSubsystem.h"
+#include "SplatEffectSubsystem.h"
+#include "SplatProjectileSubsystem.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
-#include "Components/DecalComponent.h"
+#include "Engine/Texture2DArray.h"
 #include "Kismet/GameplayStatics.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraComponent.h"
@@ -43,95 +48,260 @@ void ASplatProjectile::BeginPlay()
 {
     Super::BeginPlay();
 
-    // Create dynamic material instance
+    // Create dynamic material instance. Pooled projectiles keep it for every reuse.
     if (UMaterialInterface* BaseMaterial = ProjectileMesh->GetMaterial(0))
     {
         ProjectileMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
         ProjectileMesh->SetMaterial(0, ProjectileMaterial);
+    }
 
-        // Generate random color from HSV8 for a random vibrant color
-        ProjectileColor = FLinearColor::MakeRandomColor();
-        ProjectileColor.A = 1.0f;
-
-        // Set color material parameter
-        ProjectileMaterial->SetVectorParameterValue("Color", ProjectileColor);
+    // Projectiles spawned outside USplatProjectileSubsystem get a seed from their name, which
+    // follows spawn order and so repeats between runs. The text is hashed, not the FName's index.
+    if (!bHasShotSeed)
+    {
+        SetShotSeed(MakeShotSeed(int32(FCrc::StrCrc32(*GetName())), 0));
     }
+    SetProjectileColor(GetShotColor(ShotSeed));
 
     // Assign hit event
     CollisionSphere->OnComponentHit.AddDynamic(this, &ASplatProjectile::OnHit);
 }
 
+#if WITH_EDITOR
+void ASplatProjectile::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+    if (PropertyName == GET_MEMBER_NAME_CHECKED(ASplatProjectile, SplatTextures) ||
+        PropertyName == GET_MEMBER_NAME_CHECKED(ASplatProjectile, SplatTextureArray))
+    {
+        RebuildSplatTextureArray();
+    }
+}
+
+void ASplatProjectile::RebuildSplatTextureArray()
+{
+    if (!SplatTextureArray || SplatTextures.IsEmpty()) return;
+
+    TArray<TObjectPtr<UTexture2D>> SourceTextures;
+    for (UTexture2D* Texture : SplatTextures)
+    {
+        if (Texture) SourceTextures.Add(Texture);
+    }
+    if (SplatTextureArray->SourceTextures == SourceTextures) return;
+
+    // Slices must share size and format, which the splat textures do.
+    SplatTextureArray->Modify();
+    SplatTextureArray->SourceTextures = MoveTemp(SourceTextures);
+    SplatTextureArray->UpdateSourceFromSourceTextures();
+}
+#endif
+
 void ASplatProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor,
                              UPrimitiveComponent* OtherComp, FVector NormalImpulse,
                              const FHitResult& Hit)
 {
-    if (OtherComp)
+    // The owner is the shooter, both for pooled projectiles and for ones spawned by the subsystem.
+    USplatCoverageSubsystem* Coverage = GetWorld()->GetSubsystem<USplatCoverageSubsystem>();
+    const int32 TeamIndex = Coverage ? Coverage->GetShooterTeam(GetOwner()) : INDEX_NONE;
+
+    ApplyImpact(GetWorld(), Hit, GetVelocity(), ProjectileColor, ShotSeed, TeamIndex);
+    FinishFlight();
+}
+
+void ASplatProjectile::LifeSpanExpired()
+{
+    if (bPooled)
+    {
+        FinishFlight();
+        return;
+    }
+    Super::LifeSpanExpired();
+}
+
+// Pooled projectiles go back to the pool, others are destroyed.
+void ASplatProjectile::FinishFlight()
+{
+    USplatProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<USplatProjectileSubsystem>();
+    if (bPooled && Projectiles)
+    {
+        Projectiles->ReleaseProjectileActor(this);
+    }
+    else
+    {
+        Destroy();
+    }
+}
+
+void ASplatProjectile::ActivateFromPool(const FVector& Location, const FRotator& Rotation, int32 InShotSeed)
+{
+    SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+    SetActorHiddenInGame(false);
+    SetActorEnableCollision(true);
+
+    // A blocking hit detaches the movement component from the collision sphere, so re-arm it.
+    ProjectileMovement->SetUpdatedComponent(RootComponent);
+    ProjectileMovement->Velocity = Rotation.Vector() * ProjectileMovement->InitialSpeed;
+    ProjectileMovement->Activate(true);
+
+    // Reuse the dynamic material with the new shot's color.
+    SetShotSeed(InShotSeed);
+    SetProjectileColor(GetShotColor(ShotSeed));
+    SetLifeSpan(InitialLifeSpan);
+}
+
+void ASplatProjectile::DeactivateToPool()
+{
+    bPooled = true;
+    SetLifeSpan(0.0f);
+    ProjectileMovement->StopMovementImmediately();
+    ProjectileMovement->Deactivate();
+    SetActorEnableCollision(false);
+    SetActorHiddenInGame(true);
+}
+
+int32 ASplatProjectile::MakeShotSeed(int32 ShooterSeed, int32 ShotIndex)
+{
+    return int32(HashCombine(GetTypeHash(ShooterSeed), GetTypeHash(ShotIndex)));
+}
+
+FLinearColor ASplatProjectile::GetShotColor(int32 InShotSeed)
+{
+    // A random vibrant color from HSV8, like FLinearColor::MakeRandomColor but from the shot's stream.
+    FRandomStream Stream(InShotSeed);
+    FLinearColor Color = FLinearColor::MakeFromHSV8(uint8(Stream.RandRange(0, 255)), 255, 255);
+    Color.A = 1.0f;
+    return Color;
+}
+
+void ASplatProjectile::SetShotSeed(int32 InShotSeed)
+{
+    ShotSeed = InShotSeed;
+    bHasShotSeed = true;
+}
+
+void ASplatProjectile::SetProjectileColor(const FLinearColor& Color)
+{
+    ProjectileColor = Color;
+
+    // Set color material parameter
+    if (ProjectileMaterial)
     {
+        ProjectileMaterial->SetVectorParameterValue("Color", ProjectileColor);
+    }
+}
+
+void ASplatProjectile::ApplyImpact(UWorld* World, const FHitResult& Hit, const FVector& Velocity, const FLinearColor& Color,
+                                   int32 InShotSeed, int32 TeamIndex) const
+{
+    if (UPrimitiveComponent* OtherComp = Hit.GetComponent())
+    {
+        bool bLeftPaint = false;
+
+        // Terrain keeps its paint permanently in its paint layer instead of a timed decal.
+        AProceduralTerrain* Terrain = Cast<AProceduralTerrain>(Hit.GetActor());
+        if (Terrain && Terrain->GetPaintLayer())
+        {
+            Terrain->GetPaintLayer()->AddPaint(Hit.ImpactPoint, DecalSize, Color);
+            bLeftPaint = Terrain->GetPaintLayer()->IsInitialized();
+        }
         // If the collided object is a static mesh, apply the decal
-        if (OtherComp->GetCollisionObjectType() == ECC_WorldStatic)
+        else if (OtherComp->GetCollisionObjectType() == ECC_WorldStatic)
         {
-            SpawnSplatDecal(Hit);
+            bLeftPaint = SpawnSplatDecal(World, Hit, Color, InShotSeed);
         }
         // If it's instead a physics object, just apply force to it.
         else if (OtherComp->IsSimulatingPhysics())
         {
-            ApplyForce(OtherComp);
+            ApplyForce(OtherComp, Velocity, Hit.Location);
+        }
+
+        // Only paint that was actually left counts toward the shooter's team.
+        USplatCoverageSubsystem* Coverage = World->GetSubsystem<USplatCoverageSubsystem>();
+        if (bLeftPaint && Coverage && TeamIndex != INDEX_NONE)
+        {
+            Coverage->AddHit(Hit.GetActor(), Hit.ImpactPoint, Hit.ImpactNormal, DecalSize, TeamIndex);
         }
     }
 
-    SpawnEffect(Hit);
-    Destroy();
+    SpawnEffect(World, Hit, Color);
+}
+
+float ASplatProjectile::GetInitialSpeed() const
+{
+    return ProjectileMovement->InitialSpeed;
 }
 
-void ASplatProjectile::ApplyForce(UPrimitiveComponent* OtherComp)
+float ASplatProjectile::GetGravityScale() const
 {
-    OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
+    return ProjectileMovement->ProjectileGravityScale;
 }
 
-void ASplatProjectile::SpawnEffect(const FHitResult& Hit)
+float ASplatProjectile::GetCollisionRadius() const
 {
-    if (!NiagaraSplatEffect) return;
+    return CollisionSphere->GetUnscaledSphereRadius();
+}
 
-    UNiagaraComponent* NiagaraComp = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-        GetWorld(),
-        NiagaraSplatEffect,
-        Hit.ImpactPoint,
-        Hit.ImpactNormal.Rotation(),
-        FVector::OneVector,
-        true // Auto destroy
-    );
+UStaticMesh* ASplatProjectile::GetProjectileMesh() const
+{
+    return ProjectileMesh->GetStaticMesh();
+}
 
-    if (!NiagaraComp) return;
+UMaterialInterface* ASplatProjectile::GetInstancedMaterial() const
+{
+    return InstancedMaterial ? InstancedMaterial : ProjectileMesh->GetMaterial(0);
+}
 
-    // Set color parameter
-    NiagaraComp->SetVariableLinearColor("Color", ProjectileColor);
+void ASplatProjectile::ApplyForce(UPrimitiveComponent* OtherComp, const FVector& Velocity, const FVector& Location) const
+{
+    OtherComp->AddImpulseAtLocation(Velocity * 100.0f, Location);
 }
 
-void ASplatProjectile::SpawnSplatDecal(const FHitResult& Hit)
+void ASplatProjectile::SpawnEffect(UWorld* World, const FHitResult& Hit, const FLinearColor& Color) const
 {
-    if (!DecalMaterial || SplatTextures.IsEmpty()) return;
+    if (!NiagaraSplatEffect && !NiagaraAggregateSplatEffect) return;
+
+    USplatEffectSubsystem* Effects = World->GetSubsystem<USplatEffectSubsystem>();
+    if (!Effects) return;
 
-    // Spawn decal at the impact location
-    UDecalComponent* Decal = UGameplayStatics::SpawnDecalAtLocation(
-        GetWorld(),
-        DecalMaterial,
-        FVector(DecalSize),
-        Hit.ImpactPoint,
-        Hit.ImpactNormal.Rotation(),
-        DecalLifetime
-    );
+    // The subsystem spawns pooled components within a per-frame budget, merging or culling impacts.
+    FSplatEffectRequest Request;
+    Request.System = NiagaraSplatEffect;
+    Request.AggregateSystem = NiagaraAggregateSplatEffect;
+    Request.Location = Hit.ImpactPoint;
+    Request.Normal = Hit.ImpactNormal;
+    Request.Color = Color;
+    Effects->AddImpact(Request);
+}
+
+bool ASplatProjectile::SpawnSplatDecal(UWorld* World, const FHitResult& Hit, const FLinearColor& Color, int32 InShotSeed) const
+{
+    if (!DecalMaterial || (SplatTextures.IsEmpty() && !SplatTextureArray)) return false;
 
-    if (!Decal) return;
+    USplatDecalSubsystem* Decals = World->GetSubsystem<USplatDecalSubsystem>();
+    if (!Decals) return false;
 
-    // For fade effect in decal material
-    if (DecalLifetime != 0)
-        Decal->SetFadeOut(DecalLifetime - DecalFadeOutLength, DecalFadeOutLength);
+    FSplatDecalParams Params;
+    Params.Material = DecalMaterial;
+    Params.Color = Color;
+    Params.Size = DecalSize;
+    Params.Lifetime = DecalLifetime;
+    Params.FadeOutLength = DecalFadeOutLength;
 
-    // Get random splat texture
-    UTexture2D* RandomTexture = SplatTextures[FMath::RandRange(0, SplatTextures.Num() - 1)];
+    // Get random splat texture: a slice of the shared array, or a texture set on a per-decal material.
+    // The stream is salted so the texture does not follow the color drawn from the same seed.
+    FRandomStream Stream(int32(HashCombine(GetTypeHash(InShotSeed), 0x53504c54u)));
+    if (SplatTextureArray)
+    {
+        Params.Variant = Stream.RandRange(0, FMath::Max(SplatTextureArray->GetArraySize(), 1) - 1);
+    }
+    else
+    {
+        Params.Texture = SplatTextures[Stream.RandRange(0, SplatTextures.Num() - 1)];
+    }
 
-    // Configure decal material
-    UMaterialInstanceDynamic* DecalMaterialInstance = Decal->CreateDynamicMaterialInstance();
-    DecalMaterialInstance->SetTextureParameterValue("Texture", RandomTexture);
-    DecalMaterialInstance->SetVectorParameterValue("Color", ProjectileColor);
-}
\ No newline at end of file
+    // The decal budget recycles or merges decals instead of spawning one per hit.
+    Decals->AddSplat(Hit, Params);
+    return true;
+}
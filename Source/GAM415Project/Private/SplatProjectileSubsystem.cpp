@@ -0,0 +1,536 @@
+#include "SplatProjectileSubsystem.h"
+#include "GAM415Project.h"
+#include "SplatProjectile.h"
+#include "SplatCoverageSubsystem.h"
+#include "Portal.h"
+#include "PortalSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Async/ParallelFor.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+    // Lifetime of simulated projectiles whose class has no InitialLifeSpan.
+    constexpr float DefaultProjectileLifetime = 10.0f;
+}
+
+static TAutoConsoleVariable<bool> CVarSplatPoolActors(
+    TEXT("Splat.PoolActors"),
+    true,
+    TEXT("Recycle splat projectile actors through a pool instead of spawning and destroying one per shot."));
+
+static TAutoConsoleVariable<int32> CVarSplatRandomSeed(
+    TEXT("Splat.RandomSeed"),
+    0,
+    TEXT("Base seed of every shooter's splat colors and textures. Applies to shooters that have not fired yet."));
+
+void FSplatProjectileBatch::RemoveAtSwap(int32 Index)
+{
+    Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    Colors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    ShotSeeds.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    TeamIndices.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    Ages.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    Hits.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    bHit.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    EnteredPortals.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+bool USplatProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USplatProjectileSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(USplatProjectileSubsystem, STATGROUP_Tickables);
+}
+
+ASplatProjectile* USplatProjectileSubsystem::FireSplatProjectile(TSubclassOf<ASplatProjectile> ProjectileClass, const FVector& Location,
+                                                                 const FRotator& Rotation, AActor* Shooter)
+{
+    if (!ProjectileClass) return nullptr;
+
+    return FireSplatProjectileWithSeed(ProjectileClass, Location, Rotation, Shooter, AdvanceShotSeed(Shooter));
+}
+
+ASplatProjectile* USplatProjectileSubsystem::FireSplatProjectileWithSeed(TSubclassOf<ASplatProjectile> ProjectileClass, const FVector& Location,
+                                                                         const FRotator& Rotation, AActor* Shooter, int32 ShotSeed)
+{
+    if (!ProjectileClass) return nullptr;
+
+    const ASplatProjectile* Defaults = ProjectileClass->GetDefaultObject<ASplatProjectile>();
+
+    // Blueprint logic needs a real actor; everything else becomes a record.
+    if (Defaults->RequiresActor())
+    {
+        return AcquireProjectileActor(ProjectileClass, Location, Rotation, Shooter, ShotSeed, CVarSplatPoolActors.GetValueOnGameThread());
+    }
+
+    FSplatProjectileBatch& Batch = GetBatch(ProjectileClass);
+    USplatCoverageSubsystem* Coverage = GetWorld()->GetSubsystem<USplatCoverageSubsystem>();
+
+    Batch.Positions.Add(Location);
+    Batch.Velocities.Add(Rotation.Vector() * Defaults->GetInitialSpeed());
+    Batch.Colors.Add(ASplatProjectile::GetShotColor(ShotSeed));
+    Batch.ShotSeeds.Add(ShotSeed);
+    Batch.TeamIndices.Add(Coverage ? Coverage->GetShooterTeam(Shooter) : INDEX_NONE);
+    Batch.Ages.Add(0.0f);
+    Batch.Hits.AddDefaulted();
+    Batch.bHit.Add(false);
+    Batch.EnteredPortals.Add(nullptr);
+    return nullptr;
+}
+
+FSplatShooterSeed& USplatProjectileSubsystem::FindOrAddShooterSeed(const AActor* Shooter)
+{
+    const FObjectKey Key(Shooter);
+    if (FSplatShooterSeed* Existing = ShooterSeeds.Find(Key))
+    {
+        return *Existing;
+    }
+
+    // Actor names follow spawn order, so each shooter gets the same seed every run. The name text
+    // is hashed, as an FName's own hash is its name table index and changes between processes.
+    FSplatShooterSeed& ShooterSeed = ShooterSeeds.Add(Key);
+    const uint32 NameHash = Shooter ? FCrc::StrCrc32(*Shooter->GetName()) : 0;
+    ShooterSeed.Seed = int32(HashCombine(GetTypeHash(CVarSplatRandomSeed.GetValueOnGameThread()), NameHash));
+    return ShooterSeed;
+}
+
+void USplatProjectileSubsystem::SetShooterSeed(const AActor* Shooter, int32 Seed, int32 NextShotIndex)
+{
+    FSplatShooterSeed& ShooterSeed = FindOrAddShooterSeed(Shooter);
+    ShooterSeed.Seed = Seed;
+    ShooterSeed.NextShotIndex = NextShotIndex;
+}
+
+void USplatProjectileSubsystem::GetShooterSeed(const AActor* Shooter, int32& OutSeed, int32& OutNextShotIndex)
+{
+    const FSplatShooterSeed& ShooterSeed = FindOrAddShooterSeed(Shooter);
+    OutSeed = ShooterSeed.Seed;
+    OutNextShotIndex = ShooterSeed.NextShotIndex;
+}
+
+int32 USplatProjectileSubsystem::AdvanceShotSeed(const AActor* Shooter)
+{
+    FSplatShooterSeed& ShooterSeed = FindOrAddShooterSeed(Shooter);
+    return ASplatProjectile::MakeShotSeed(ShooterSeed.Seed, ShooterSeed.NextShotIndex++);
+}
+
+int32 USplatProjectileSubsystem::GetNumSimulatedProjectiles() const
+{
+    int32 Num = 0;
+    for (const FSplatProjectileBatch& Batch : Batches)
+    {
+        Num += Batch.Num();
+    }
+    return Num;
+}
+
+ASplatProjectile* USplatProjectileSubsystem::AcquireProjectileActor(TSubclassOf<ASplatProjectile> ProjectileClass, const FVector& Location,
+                                                                    const FRotator& Rotation, AActor* Shooter, int32 ShotSeed, bool bUsePool)
+{
+    if (!ProjectileClass) return nullptr;
+
+    if (!bUsePool)
+    {
+        // Deferred so the seed is in place before BeginPlay colors the projectile.
+        const FTransform SpawnTransform(Rotation, Location);
+        ASplatProjectile* Projectile = GetWorld()->SpawnActorDeferred<ASplatProjectile>(
+            ProjectileClass, SpawnTransform, Shooter, Cast<APawn>(Shooter), ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+        if (Projectile)
+        {
+            Projectile->SetShotSeed(ShotSeed);
+            Projectile->FinishSpawning(SpawnTransform);
+        }
+        return Projectile;
+    }
+
+    // Take the most recently returned projectile, or grow the pool by one.
+    FSplatProjectilePool& Pool = ActorPools.FindOrAdd(ProjectileClass);
+    ASplatProjectile* Projectile = nullptr;
+    while (!Projectile && !Pool.Inactive.IsEmpty())
+    {
+        Projectile = Pool.Inactive.Pop(EAllowShrinking::No);
+        if (!IsValid(Projectile)) Projectile = nullptr;
+    }
+    if (!Projectile)
+    {
+        Projectile = SpawnPooledActor(ProjectileClass);
+        if (!Projectile) return nullptr;
+    }
+
+    Projectile->SetOwner(Shooter);
+    Projectile->SetInstigator(Cast<APawn>(Shooter));
+    Projectile->ActivateFromPool(Location, Rotation, ShotSeed);
+    return Projectile;
+}
+
+void USplatProjectileSubsystem::ReleaseProjectileActor(ASplatProjectile* Projectile)
+{
+    if (!IsValid(Projectile)) return;
+
+    Projectile->DeactivateToPool();
+    ActorPools.FindOrAdd(Projectile->GetClass()).Inactive.Add(Projectile);
+}
+
+void USplatProjectileSubsystem::PrewarmActorPool(TSubclassOf<ASplatProjectile> ProjectileClass, int32 Count)
+{
+    if (!ProjectileClass) return;
+
+    FSplatProjectilePool& Pool = ActorPools.FindOrAdd(ProjectileClass);
+    Pool.Inactive.Reserve(Pool.Inactive.Num() + Count);
+    for (int32 i = 0; i < Count; i++)
+    {
+        if (ASplatProjectile* Projectile = SpawnPooledActor(ProjectileClass))
+        {
+            Pool.Inactive.Add(Projectile);
+        }
+    }
+}
+
+ASplatProjectile* USplatProjectileSubsystem::SpawnPooledActor(TSubclassOf<ASplatProjectile> ProjectileClass)
+{
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    ASplatProjectile* Projectile = GetWorld()->SpawnActor<ASplatProjectile>(ProjectileClass, FTransform::Identity, SpawnParams);
+    if (Projectile)
+    {
+        Projectile->DeactivateToPool();
+    }
+    return Projectile;
+}
+
+void USplatProjectileSubsystem::Tick(float DeltaTime)
+{
+    // Portal surfaces only overlap projectiles, which the sweeps ignore, so entries are found separately.
+    Portals.Reset();
+    if (const UPortalSubsystem* PortalSubsystem = GetWorld()->GetSubsystem<UPortalSubsystem>())
+    {
+        for (const APortal* Portal : PortalSubsystem->GetPortals())
+        {
+            if (Portal && Portal->HasLinkedPortal()) Portals.Add(Portal);
+        }
+    }
+
+    for (FSplatProjectileBatch& Batch : Batches)
+    {
+        if (Batch.Num() == 0 && (!Batch.Instances || Batch.Instances->GetInstanceCount() == 0)) continue;
+
+        SimulateBatch(Batch, DeltaTime);
+        ResolveBatch(Batch, DeltaTime);
+    }
+}
+
+FSplatProjectileBatch& USplatProjectileSubsystem::GetBatch(TSubclassOf<ASplatProjectile> ProjectileClass)
+{
+    for (FSplatProjectileBatch& Batch : Batches)
+    {
+        if (Batch.ProjectileClass == ProjectileClass) return Batch;
+    }
+
+    UWorld* World = GetWorld();
+    if (!RenderActor)
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.ObjectFlags |= RF_Transient;
+        RenderActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+        RenderActor->SetRootComponent(NewObject<USceneComponent>(RenderActor, TEXT("Root")));
+        RenderActor->GetRootComponent()->RegisterComponent();
+    }
+
+    const ASplatProjectile* Defaults = ProjectileClass->GetDefaultObject<ASplatProjectile>();
+
+    FSplatProjectileBatch& Batch = Batches.AddDefaulted_GetRef();
+    Batch.ProjectileClass = ProjectileClass;
+    Batch.Lifetime = Defaults->GetSimulatedLifetime() > 0.0f ? Defaults->GetSimulatedLifetime() : DefaultProjectileLifetime;
+
+    // One instanced mesh draws every projectile of the class; the color goes in per-instance custom data.
+    Batch.Instances = NewObject<UInstancedStaticMeshComponent>(RenderActor);
+    Batch.Instances->SetupAttachment(RenderActor->GetRootComponent());
+    Batch.Instances->SetStaticMesh(Defaults->GetProjectileMesh());
+    Batch.Instances->SetMaterial(0, Defaults->GetInstancedMaterial());
+    Batch.Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    Batch.Instances->SetMobility(EComponentMobility::Movable);
+    Batch.Instances->NumCustomDataFloats = 3;
+    Batch.Instances->RegisterComponent();
+    return Batch;
+}
+
+// Integrates every projectile and sweeps its path for this frame. The sweeps are read-only
+// scene queries, so they run in parallel across the batch.
+void USplatProjectileSubsystem::SimulateBatch(FSplatProjectileBatch& Batch, float DeltaTime) const
+{
+    const UWorld* World = GetWorld();
+    const ASplatProjectile* Defaults = Batch.ProjectileClass->GetDefaultObject<ASplatProjectile>();
+    const FVector Gravity(0.0f, 0.0f, World->GetGravityZ() * Defaults->GetGravityScale());
+    const FCollisionShape Shape = FCollisionShape::MakeSphere(Defaults->GetCollisionRadius());
+
+    // Match the projectile collision profile: the Projectile channel, ignoring pawns.
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SplatProjectile));
+    FCollisionResponseParams ResponseParams;
+    ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+
+    ParallelFor(Batch.Num(), [&](int32 i)
+    {
+        const FVector Start = Batch.Positions[i];
+        const FVector Velocity = Batch.Velocities[i] + Gravity * DeltaTime;
+        FVector End = Start + Velocity * DeltaTime;
+
+        // Stop at the first portal entered; the sweep only covers the path up to it, so the wall
+        // a portal sits on is never hit through the portal.
+        const APortal* EnteredPortal = nullptr;
+        float EntryTime = 1.0f;
+        for (const APortal* Portal : Portals)
+        {
+            float Time;
+            if (Portal->FindEntry(Start, End, Shape.GetSphereRadius(), Time) && Time < EntryTime)
+            {
+                EnteredPortal = Portal;
+                EntryTime = Time;
+            }
+        }
+        if (EnteredPortal)
+        {
+            End = FMath::Lerp(Start, End, EntryTime);
+        }
+
+        Batch.bHit[i] = World->SweepSingleByChannel(Batch.Hits[i], Start, End, FQuat::Identity, ECC_GameTraceChannel1,
+                                                    Shape, QueryParams, ResponseParams);
+        Batch.EnteredPortals[i] = Batch.bHit[i] ? nullptr : EnteredPortal;
+        Batch.Velocities[i] = Velocity;
+        Batch.Positions[i] = Batch.bHit[i] ? FVector(Batch.Hits[i].Location) : End;
+    });
+}
+
+void USplatProjectileSubsystem::ResolveBatch(FSplatProjectileBatch& Batch, float DeltaTime)
+{
+    UWorld* World = GetWorld();
+    const ASplatProjectile* Defaults = Batch.ProjectileClass->GetDefaultObject<ASplatProjectile>();
+
+    // Walk backwards so swapped-in projectiles have already been visited.
+    for (int32 i = Batch.Num() - 1; i >= 0; i--)
+    {
+        Batch.Ages[i] += DeltaTime;
+
+        if (Batch.bHit[i])
+        {
+            Defaults->ApplyImpact(World, Batch.Hits[i], Batch.Velocities[i], Batch.Colors[i], Batch.ShotSeeds[i],
+                                  Batch.TeamIndices[i]);
+            Batch.RemoveAtSwap(i);
+        }
+        else if (Batch.Ages[i] > Batch.Lifetime)
+        {
+            Batch.RemoveAtSwap(i);
+        }
+        else if (Batch.EnteredPortals[i])
+        {
+            // Portal transforms are applied here on the game thread, as they read the linked portal.
+            Batch.EnteredPortals[i]->TransformThroughPortal(Batch.Positions[i], Batch.Velocities[i]);
+        }
+    }
+
+    UpdateInstances(Batch);
+}
+
+void USplatProjectileSubsystem::UpdateInstances(FSplatProjectileBatch& Batch)
+{
+    UInstancedStaticMeshComponent* Instances = Batch.Instances;
+    if (!Instances) return;
+
+    // Grow or shrink the instance list to the projectile count; removing from the end keeps indices stable.
+    const int32 NumInstances = Instances->GetInstanceCount();
+    if (NumInstances < Batch.Num())
+    {
+        TArray<FTransform> NewTransforms;
+        NewTransforms.Init(FTransform::Identity, Batch.Num() - NumInstances);
+        Instances->AddInstances(NewTransforms, false, true);
+    }
+    else if (NumInstances > Batch.Num())
+    {
+        TArray<int32> RemovedIndices;
+        for (int32 i = Batch.Num(); i < NumInstances; i++)
+        {
+            RemovedIndices.Add(i);
+        }
+        Instances->RemoveInstances(RemovedIndices);
+    }
+
+    if (Batch.Num() == 0) return;
+
+    TArray<FTransform> Transforms;
+    Transforms.Reserve(Batch.Num());
+    for (int32 i = 0; i < Batch.Num(); i++)
+    {
+        Transforms.Emplace(Batch.Velocities[i].Rotation(), Batch.Positions[i]);
+    }
+    Instances->BatchUpdateInstancesTransforms(0, Transforms, true, false, true);
+
+    // Records move around when others are removed, so every instance gets its color again. Only
+    // the last update flags the instances for upload, so the proxy is not rebuilt per instance.
+    for (int32 i = 0; i < Batch.Num(); i++)
+    {
+        const FLinearColor& Color = Batch.Colors[i];
+        const float CustomData[3] = { Color.R, Color.G, Color.B };
+        Instances->SetCustomData(i, CustomData, i == Batch.Num() - 1);
+    }
+}
+
+/// | Benchmark | ///
+
+namespace
+{
+    // State of a running Splat.BenchmarkActors session.
+    struct FSplatActorBenchmark
+    {
+        TWeakObjectPtr<UWorld> World;
+        TSubclassOf<ASplatProjectile> ProjectileClass;
+        FTimerHandle FireTimer;
+        FDelegateHandle PreGCHandle;
+        FDelegateHandle PostGCHandle;
+
+        int32 ShotsPerRun = 0;
+        int32 ShotsFired = 0;
+        bool bPooled = false;
+
+        // Per-run measurements.
+        double SpawnSeconds = 0.0;
+        double MaxSpawnSeconds = 0.0;
+        int32 NumGCs = 0;
+        double GCStartTime = 0.0;
+        double GCSeconds = 0.0;
+        double MaxGCSeconds = 0.0;
+        double RunStartTime = 0.0;
+    };
+
+    constexpr float BenchmarkShotsPerSecond = 30.0f;
+
+    void StartBenchmarkRun(const TSharedRef<FSplatActorBenchmark>& Benchmark, bool bPooled);
+
+    // Logs the finished run, then starts the pooled run or ends the benchmark.
+    void FinishBenchmarkRun(const TSharedRef<FSplatActorBenchmark>& Benchmark)
+    {
+        UWorld* World = Benchmark->World.Get();
+        const double RunSeconds = FPlatformTime::Seconds() - Benchmark->RunStartTime;
+        const int32 Shots = FMath::Max(Benchmark->ShotsFired, 1);
+
+        UE_LOG(LogGAM415Project, Display,
+               TEXT("Splat actor benchmark (%s), %d shots over %.1f s: spawn %.3f ms avg, %.3f ms max; %d GC(s) (%.2f per minute), %.1f ms total GC, %.1f ms max GC"),
+               Benchmark->bPooled ? TEXT("pooled") : TEXT("spawn/destroy"), Benchmark->ShotsFired, RunSeconds,
+               Benchmark->SpawnSeconds * 1000.0 / Shots, Benchmark->MaxSpawnSeconds * 1000.0,
+               Benchmark->NumGCs, Benchmark->NumGCs * 60.0 / FMath::Max(RunSeconds, 1e-3),
+               Benchmark->GCSeconds * 1000.0, Benchmark->MaxGCSeconds * 1000.0);
+
+        if (World)
+        {
+            World->GetTimerManager().ClearTimer(Benchmark->FireTimer);
+        }
+
+        if (!Benchmark->bPooled && World)
+        {
+            StartBenchmarkRun(Benchmark, true);
+            return;
+        }
+
+        FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(Benchmark->PreGCHandle);
+        FCoreUObjectDelegates::GetPostGarbageCollect().Remove(Benchmark->PostGCHandle);
+    }
+
+    // Fires ShotsPerRun projectiles from the player's view at a steady 30 shots per second.
+    void StartBenchmarkRun(const TSharedRef<FSplatActorBenchmark>& Benchmark, bool bPooled)
+    {
+        UWorld* World = Benchmark->World.Get();
+
+        Benchmark->bPooled = bPooled;
+        Benchmark->ShotsFired = 0;
+        Benchmark->SpawnSeconds = 0.0;
+        Benchmark->MaxSpawnSeconds = 0.0;
+        Benchmark->NumGCs = 0;
+        Benchmark->GCSeconds = 0.0;
+        Benchmark->MaxGCSeconds = 0.0;
+        Benchmark->RunStartTime = FPlatformTime::Seconds();
+
+        World->GetTimerManager().SetTimer(Benchmark->FireTimer, FTimerDelegate::CreateLambda([Benchmark]()
+        {
+            UWorld* World = Benchmark->World.Get();
+            USplatProjectileSubsystem* Subsystem = World ? World->GetSubsystem<USplatProjectileSubsystem>() : nullptr;
+            APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+            if (!Subsystem || !PlayerController) return;
+
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+            const double StartTime = FPlatformTime::Seconds();
+            Subsystem->AcquireProjectileActor(Benchmark->ProjectileClass, ViewLocation + ViewRotation.Vector() * 100.0f,
+                                              ViewRotation, PlayerController->GetPawn(),
+                                              Subsystem->AdvanceShotSeed(PlayerController->GetPawn()), Benchmark->bPooled);
+            const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+            Benchmark->SpawnSeconds += Seconds;
+            Benchmark->MaxSpawnSeconds = FMath::Max(Benchmark->MaxSpawnSeconds, Seconds);
+            if (++Benchmark->ShotsFired >= Benchmark->ShotsPerRun)
+            {
+                FinishBenchmarkRun(Benchmark);
+            }
+        }), 1.0f / BenchmarkShotsPerSecond, true);
+    }
+}
+
+// Fires splat projectile actors at 30 shots/second from the player's view, first spawning and
+// destroying one per shot, then through the actor pool, and logs spawn cost and GC pauses of each run.
+// Usage: Splat.BenchmarkActors [Seconds=20] [ProjectileClassPath]
+static void RunSplatActorBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    if (!World || !World->GetFirstPlayerController() || !World->GetSubsystem<USplatProjectileSubsystem>())
+    {
+        UE_LOG(LogGAM415Project, Warning, TEXT("Splat.BenchmarkActors needs a game world with a player"));
+        return;
+    }
+
+    const float Seconds = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 1.0f) : 20.0f;
+
+    TSubclassOf<ASplatProjectile> ProjectileClass = ASplatProjectile::StaticClass();
+    if (Args.Num() > 1)
+    {
+        if (UClass* LoadedClass = LoadClass<ASplatProjectile>(nullptr, *Args[1]))
+        {
+            ProjectileClass = LoadedClass;
+        }
+        else
+        {
+            UE_LOG(LogGAM415Project, Warning, TEXT("Splat.BenchmarkActors: could not load %s, using ASplatProjectile"), *Args[1]);
+        }
+    }
+
+    TSharedRef<FSplatActorBenchmark> Benchmark = MakeShared<FSplatActorBenchmark>();
+    Benchmark->World = World;
+    Benchmark->ProjectileClass = ProjectileClass;
+    Benchmark->ShotsPerRun = FMath::CeilToInt(Seconds * BenchmarkShotsPerSecond);
+
+    // Time every garbage collection that happens while the benchmark runs.
+    Benchmark->PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddLambda([Benchmark]()
+    {
+        Benchmark->GCStartTime = FPlatformTime::Seconds();
+    });
+    Benchmark->PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([Benchmark]()
+    {
+        const double GCSeconds = FPlatformTime::Seconds() - Benchmark->GCStartTime;
+        Benchmark->NumGCs++;
+        Benchmark->GCSeconds += GCSeconds;
+        Benchmark->MaxGCSeconds = FMath::Max(Benchmark->MaxGCSeconds, GCSeconds);
+    });
+
+    StartBenchmarkRun(Benchmark, false);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GSplatActorBenchmarkCommand(
+    TEXT("Splat.BenchmarkActors"),
+    TEXT("Fires splat projectile actors at 30 shots/s, spawning one per shot and then from the actor pool, and logs spawn cost and GC pauses. Args: [Seconds=20] [ProjectileClassPath]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunSplatActorBenchmark));
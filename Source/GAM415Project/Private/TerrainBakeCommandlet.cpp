@@ -0,0 +1,155 @@
+#include "TerrainBakeCommandlet.h"
+#include "GAM415Project.h"
+#include "ProceduralTerrain.h"
+#include "TerrainGenerator.h"
+#include "TerrainHeightCache.h"
+#include "Misc/FileHelper.h"
+
+UTerrainBakeCommandlet::UTerrainBakeCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UTerrainBakeCommandlet::Main(const FString& Params)
+{
+    // Start from the terrain actor defaults so an unconfigured bake matches what the level spawns.
+    const FTerrainGenerationParams Defaults = GetDefault<AProceduralTerrain>()->GetGenerationParams();
+
+    TArray<FTerrainGenerationParams> Sets;
+    FString SetsFile;
+    if (FParse::Value(*Params, TEXT("-SetsFile="), SetsFile))
+    {
+        TArray<FString> Lines;
+        if (!FFileHelper::LoadFileToStringArray(Lines, *SetsFile))
+        {
+            UE_LOG(LogGAM415Project, Error, TEXT("Could not read parameter sets from %s"), *SetsFile);
+            return 1;
+        }
+
+        // Each line refines every set of the command line, which in turn refines the actor
+        // defaults, so -Seeds=1,2,3 bakes every line of the file once per seed.
+        TArray<FTerrainGenerationParams> CommandLineSets;
+        ParseParameterSets(Params, Defaults, CommandLineSets);
+        for (const FTerrainGenerationParams& CommandLineSet : CommandLineSets)
+        {
+            for (const FString& Line : Lines)
+            {
+                const FString Trimmed = Line.TrimStartAndEnd();
+                if (Trimmed.IsEmpty() || Trimmed.StartsWith(TEXT("#"))) continue;
+                ParseParameterSets(Trimmed, CommandLineSet, Sets);
+            }
+        }
+    }
+    else
+    {
+        ParseParameterSets(Params, Defaults, Sets);
+    }
+
+    const bool bPrebaked = !FParse::Param(*Params, TEXT("Local"));
+    int32 NumWorkers = 0;
+    FParse::Value(*Params, TEXT("-Workers="), NumWorkers);
+
+    UE_LOG(LogGAM415Project, Display, TEXT("Baking %d terrain parameter set(s) to %s"), Sets.Num(),
+           bPrebaked ? *FTerrainHeightCache::GetPrebakedDirectory() : *FTerrainHeightCache::GetCacheDirectory());
+
+    int32 NumFailed = 0;
+    int64 TotalVertices = 0;
+    int64 TotalDroplets = 0;
+    double TotalSeconds = 0.0;
+
+    // Lines that set their own seed expand to the same set for every command line seed; bake it once.
+    TSet<uint64> BakedKeys;
+
+    for (const FTerrainGenerationParams& Set : Sets)
+    {
+        const FIntPoint GridSize = Set.GetHeightfieldSize();
+        const uint64 Key = Set.GetCacheKey();
+
+        bool bAlreadyBaked = false;
+        BakedKeys.Add(Key, &bAlreadyBaked);
+        if (bAlreadyBaked) continue;
+
+        TArray<float> Heights;
+        const double StartTime = FPlatformTime::Seconds();
+        const FTerrainErosionStats Stats = FTerrainGenerator::GenerateHeightfield(Set, Heights, NumWorkers);
+        const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+        if (!FTerrainHeightCache::Save(Key, GridSize, Heights, bPrebaked))
+        {
+            NumFailed++;
+            continue;
+        }
+
+        const int64 NumVertices = int64(GridSize.X) * GridSize.Y;
+        TotalVertices += NumVertices;
+        TotalDroplets += Stats.Droplets;
+        TotalSeconds += Seconds;
+
+        UE_LOG(LogGAM415Project, Display,
+               TEXT("Seed %d (%dx%d chunks, %dx%d vertices%s) -> %016llx: %.1f ms, %.2f M vertices/s, %.0f droplets/s"),
+               Set.Seed, Set.GetNumChunks().X, Set.GetNumChunks().Y, GridSize.X, GridSize.Y,
+               Set.bEnableErosion ? TEXT(", eroded") : TEXT(""), Key, Seconds * 1000.0,
+               NumVertices / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER) / 1e6,
+               Stats.Droplets / FMath::Max(Seconds, UE_DOUBLE_SMALL_NUMBER));
+    }
+
+    UE_LOG(LogGAM415Project, Display, TEXT("Baked %d set(s) in %.2f s (%.2f M vertices/s, %.0f droplets/s), %d failed"),
+           BakedKeys.Num() - NumFailed, TotalSeconds,
+           TotalVertices / FMath::Max(TotalSeconds, UE_DOUBLE_SMALL_NUMBER) / 1e6,
+           TotalDroplets / FMath::Max(TotalSeconds, UE_DOUBLE_SMALL_NUMBER), NumFailed);
+
+    return NumFailed > 0 ? 1 : 0;
+}
+
+void UTerrainBakeCommandlet::ParseParameterSets(const FString& Line, const FTerrainGenerationParams& Base,
+                                                TArray<FTerrainGenerationParams>& OutSets)
+{
+    FTerrainGenerationParams Set = Base;
+    FParse::Value(*Line, TEXT("-XSize="), Set.XSize);
+    FParse::Value(*Line, TEXT("-YSize="), Set.YSize);
+    FParse::Value(*Line, TEXT("-Scale="), Set.Scale);
+    FParse::Value(*Line, TEXT("-HeightScale="), Set.HeightScale);
+    FParse::Value(*Line, TEXT("-NoiseScale="), Set.NoiseScale);
+    FParse::Value(*Line, TEXT("-ChunkSize="), Set.ChunkSize);
+
+    double OriginX = Set.Origin.X, OriginY = Set.Origin.Y;
+    FParse::Value(*Line, TEXT("-OriginX="), OriginX);
+    FParse::Value(*Line, TEXT("-OriginY="), OriginY);
+    Set.Origin = FVector2D(OriginX, OriginY);
+
+    if (FParse::Param(*Line, TEXT("Erosion"))) Set.bEnableErosion = true;
+    if (FParse::Param(*Line, TEXT("NoErosion"))) Set.bEnableErosion = false;
+
+    Set.ChunkSize = FMath::Max(Set.ChunkSize, 2);
+
+    // A single -Seed or a comma separated -Seeds list expands into one set per seed.
+    TArray<int32> Seeds;
+    FString SeedList;
+    if (FParse::Value(*Line, TEXT("-Seeds="), SeedList, false))
+    {
+        TArray<FString> Tokens;
+        SeedList.ParseIntoArray(Tokens, TEXT(","));
+        for (const FString& Token : Tokens)
+        {
+            Seeds.Add(FCString::Atoi(*Token));
+        }
+    }
+    else if (FParse::Value(*Line, TEXT("-Seed="), Set.Seed))
+    {
+        Seeds.Add(Set.Seed);
+    }
+
+    if (Seeds.IsEmpty())
+    {
+        Seeds.Add(Set.Seed);
+    }
+
+    for (int32 SetSeed : Seeds)
+    {
+        Set.Seed = SetSeed;
+        OutSets.Add(Set);
+    }
+}
@@ -0,0 +1,372 @@
+#include "TerrainErosion.h"
+#include "GAM415Project.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+FArchive& operator<<(FArchive& Ar, FTerrainErosionSettings& Settings)
+{
+    Ar << Settings.Passes;
+    Ar << Settings.DropletsPerChunk;
+    Ar << Settings.MaxDropletLifetime;
+    Ar << Settings.Inertia;
+    Ar << Settings.SedimentCapacity;
+    Ar << Settings.MinSedimentCapacity;
+    Ar << Settings.ErodeSpeed;
+    Ar << Settings.DepositSpeed;
+    Ar << Settings.EvaporateSpeed;
+    Ar << Settings.Gravity;
+    Ar << Settings.ThermalIterations;
+    Ar << Settings.TalusAngle;
+    Ar << Settings.ThermalRate;
+    return Ar;
+}
+
+namespace
+{
+    // One chunk's share of the heightfield while eroding.
+    struct FErosionTile
+    {
+        // Vertices this tile owns: droplets start here and merged results land here (max exclusive).
+        FIntPoint CoreMin;
+        FIntPoint CoreMax;
+
+        // Vertices copied into the tile: the core plus a halo from its neighbours (max exclusive).
+        FIntPoint ExtMin;
+        FIntPoint ExtMax;
+
+        // Working heights over the extended rectangle.
+        TArray<float> Heights;
+
+        // Changes made during the current pass over the extended rectangle.
+        TArray<float> Delta;
+
+        FTerrainErosionStats Stats;
+
+        FIntPoint GetExtSize() const { return ExtMax - ExtMin; }
+    };
+
+    // Bilinearly interpolated height and slope at a position in tile grid units.
+    void SampleHeightAndGradient(const TArray<float>& Heights, int32 SizeY, float X, float Y, float& OutHeight, FVector2f& OutGradient)
+    {
+        const int32 NodeX = FMath::FloorToInt(X);
+        const int32 NodeY = FMath::FloorToInt(Y);
+        const float U = X - NodeX;
+        const float V = Y - NodeY;
+
+        const int32 Index = NodeX * SizeY + NodeY;
+        const float H00 = Heights[Index];
+        const float H01 = Heights[Index + 1];
+        const float H10 = Heights[Index + SizeY];
+        const float H11 = Heights[Index + SizeY + 1];
+
+        OutGradient.X = (H10 - H00) * (1 - V) + (H11 - H01) * V;
+        OutGradient.Y = (H01 - H00) * (1 - U) + (H11 - H10) * U;
+        OutHeight = H00 * (1 - U) * (1 - V) + H10 * U * (1 - V) + H01 * (1 - U) * V + H11 * U * V;
+    }
+
+    // Runs one water droplet from a random point in the tile core until it stops or leaves the tile.
+    void SimulateDroplet(FErosionTile& Tile, FRandomStream& Stream, const FTerrainErosionSettings& Settings)
+    {
+        const FIntPoint Size = Tile.GetExtSize();
+        const FIntPoint CoreOffset = Tile.CoreMin - Tile.ExtMin;
+        const FIntPoint CoreSize = Tile.CoreMax - Tile.CoreMin;
+
+        FVector2f Position(CoreOffset.X + Stream.FRand() * (CoreSize.X - 1),
+                           CoreOffset.Y + Stream.FRand() * (CoreSize.Y - 1));
+        FVector2f Direction(0, 0);
+        float Speed = 1.0f;
+        float Water = 1.0f;
+        float Sediment = 0.0f;
+
+        for (int32 Step = 0; Step < Settings.MaxDropletLifetime; ++Step)
+        {
+            const int32 NodeX = FMath::FloorToInt(Position.X);
+            const int32 NodeY = FMath::FloorToInt(Position.Y);
+            const float U = Position.X - NodeX;
+            const float V = Position.Y - NodeY;
+
+            float Height;
+            FVector2f Gradient;
+            SampleHeightAndGradient(Tile.Heights, Size.Y, Position.X, Position.Y, Height, Gradient);
+
+            // Blend the previous direction with the downhill direction.
+            Direction = Direction * Settings.Inertia - Gradient * (1 - Settings.Inertia);
+            const float DirectionLength = Direction.Size();
+            if (DirectionLength < UE_KINDA_SMALL_NUMBER) break;
+            Direction /= DirectionLength;
+
+            Position += Direction;
+            ++Tile.Stats.DropletSteps;
+
+            // Stop at the edge of the copied region; the halo is sized so this is rare.
+            if (Position.X < 0 || Position.Y < 0 || Position.X >= Size.X - 1 || Position.Y >= Size.Y - 1) break;
+
+            float NewHeight;
+            FVector2f NewGradient;
+            SampleHeightAndGradient(Tile.Heights, Size.Y, Position.X, Position.Y, NewHeight, NewGradient);
+            const float DeltaHeight = NewHeight - Height;
+
+            // Sediment is exchanged with the four vertices around the previous position.
+            const int32 Index = NodeX * Size.Y + NodeY;
+            const int32 Corners[4] = {Index, Index + Size.Y, Index + 1, Index + Size.Y + 1};
+            const float Weights[4] = {(1 - U) * (1 - V), U * (1 - V), (1 - U) * V, U * V};
+
+            const float Capacity = FMath::Max(-DeltaHeight * Speed * Water * Settings.SedimentCapacity,
+                                              Settings.MinSedimentCapacity);
+
+            if (Sediment > Capacity || DeltaHeight > 0)
+            {
+                // Going uphill fills the pit behind; otherwise drop part of the surplus.
+                const float Amount = DeltaHeight > 0
+                    ? FMath::Min(DeltaHeight, Sediment)
+                    : (Sediment - Capacity) * Settings.DepositSpeed;
+                Sediment -= Amount;
+                for (int32 i = 0; i < 4; ++i) Tile.Heights[Corners[i]] += Amount * Weights[i];
+            }
+            else
+            {
+                // Never take more than the drop in height, which would carve holes.
+                const float Amount = FMath::Min((Capacity - Sediment) * Settings.ErodeSpeed, -DeltaHeight);
+                Sediment += Amount;
+                for (int32 i = 0; i < 4; ++i) Tile.Heights[Corners[i]] -= Amount * Weights[i];
+            }
+
+            Speed = FMath::Sqrt(FMath::Max(Speed * Speed - DeltaHeight * Settings.Gravity, 0.0f));
+            Water *= 1 - Settings.EvaporateSpeed;
+        }
+
+        ++Tile.Stats.Droplets;
+    }
+
+    // Moves material from core vertices down to lower neighbours wherever the slope exceeds the talus.
+    void RelaxTalus(FErosionTile& Tile, float MaxDifference, float Rate)
+    {
+        static const FIntPoint Offsets[4] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+        const FIntPoint Size = Tile.GetExtSize();
+        const FIntPoint Min = Tile.CoreMin - Tile.ExtMin;
+        const FIntPoint Max = Tile.CoreMax - Tile.ExtMin;
+
+        for (int32 x = Min.X; x < Max.X; ++x)
+        {
+            for (int32 y = Min.Y; y < Max.Y; ++y)
+            {
+                float& Height = Tile.Heights[x * Size.Y + y];
+
+                for (const FIntPoint& Offset : Offsets)
+                {
+                    const int32 nx = x + Offset.X;
+                    const int32 ny = y + Offset.Y;
+                    if (nx < 0 || ny < 0 || nx >= Size.X || ny >= Size.Y) continue;
+
+                    float& Neighbour = Tile.Heights[nx * Size.Y + ny];
+                    const float Difference = Height - Neighbour;
+                    if (Difference > MaxDifference)
+                    {
+                        const float Moved = (Difference - MaxDifference) * Rate;
+                        Height -= Moved;
+                        Neighbour += Moved;
+                    }
+                }
+            }
+        }
+
+        Tile.Stats.ThermalCellUpdates += int64(Max.X - Min.X) * (Max.Y - Min.Y);
+    }
+
+    // Runs Body for [0, Num) on at most NumWorkers parallel workers (0 means no limit).
+    void RunParallel(int32 Num, int32 NumWorkers, TFunctionRef<void(int32)> Body)
+    {
+        if (NumWorkers <= 0)
+        {
+            ParallelFor(Num, Body);
+            return;
+        }
+
+        const int32 Workers = FMath::Clamp(NumWorkers, 1, FMath::Max(Num, 1));
+        ParallelFor(Workers, [&](int32 Worker)
+        {
+            for (int32 Index = Worker; Index < Num; Index += Workers)
+            {
+                Body(Index);
+            }
+        }, Workers == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+    }
+}
+
+FTerrainErosionStats FTerrainErosion::Erode(TArray<float>& Heights, const FIntPoint& GridSize, int32 CellsPerChunk,
+                                            float CellSize, const FTerrainErosionSettings& Settings, int32 Seed,
+                                            int32 NumWorkers)
+{
+    FTerrainErosionStats Total;
+    if (Heights.Num() != GridSize.X * GridSize.Y || GridSize.X < 2 || GridSize.Y < 2 ||
+        CellsPerChunk < 1 || CellSize <= 0)
+    {
+        return Total;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    // One tile per chunk. Droplets never travel further than their lifetime, so a halo
+    // slightly larger than that keeps every change a tile makes inside its own copy.
+    const FIntPoint NumTiles(FMath::DivideAndRoundUp(GridSize.X - 1, CellsPerChunk),
+                             FMath::DivideAndRoundUp(GridSize.Y - 1, CellsPerChunk));
+    const int32 Halo = Settings.MaxDropletLifetime + 2;
+    const int32 Reach = FMath::DivideAndRoundUp(Halo, CellsPerChunk);
+
+    TArray<FErosionTile> Tiles;
+    Tiles.SetNum(NumTiles.X * NumTiles.Y);
+
+    for (int32 tx = 0; tx < NumTiles.X; ++tx)
+    {
+        for (int32 ty = 0; ty < NumTiles.Y; ++ty)
+        {
+            FErosionTile& Tile = Tiles[tx * NumTiles.Y + ty];
+
+            // Chunks share their border vertices; the last tile on each axis owns the final row.
+            Tile.CoreMin = FIntPoint(tx * CellsPerChunk, ty * CellsPerChunk);
+            Tile.CoreMax = FIntPoint(tx == NumTiles.X - 1 ? GridSize.X : (tx + 1) * CellsPerChunk,
+                                     ty == NumTiles.Y - 1 ? GridSize.Y : (ty + 1) * CellsPerChunk);
+            Tile.ExtMin = (Tile.CoreMin - FIntPoint(Halo, Halo)).ComponentMax(FIntPoint(0, 0));
+            Tile.ExtMax = (Tile.CoreMax + FIntPoint(Halo, Halo)).ComponentMin(GridSize);
+
+            const FIntPoint ExtSize = Tile.GetExtSize();
+            Tile.Heights.SetNumUninitialized(ExtSize.X * ExtSize.Y);
+            Tile.Delta.SetNumUninitialized(ExtSize.X * ExtSize.Y);
+        }
+    }
+
+    // Erode in grid units so the tunables don't depend on vertex spacing.
+    for (float& Height : Heights) Height /= CellSize;
+
+    const float MaxTalusDifference = FMath::Tan(FMath::DegreesToRadians(Settings.TalusAngle));
+    const int32 Passes = FMath::Max(Settings.Passes, 1);
+
+    for (int32 Pass = 0; Pass < Passes; ++Pass)
+    {
+        // Spread the work evenly over the passes.
+        const int32 Droplets = Settings.DropletsPerChunk * (Pass + 1) / Passes - Settings.DropletsPerChunk * Pass / Passes;
+        const int32 ThermalSteps = Settings.ThermalIterations * (Pass + 1) / Passes - Settings.ThermalIterations * Pass / Passes;
+
+        // Erode every tile on its own copy; the shared heights are only read here.
+        RunParallel(Tiles.Num(), NumWorkers, [&](int32 TileIndex)
+        {
+            FErosionTile& Tile = Tiles[TileIndex];
+            const int32 ExtSizeY = Tile.GetExtSize().Y;
+
+            for (int32 x = Tile.ExtMin.X; x < Tile.ExtMax.X; ++x)
+            {
+                FMemory::Memcpy(&Tile.Heights[(x - Tile.ExtMin.X) * ExtSizeY],
+                                &Heights[x * GridSize.Y + Tile.ExtMin.Y],
+                                ExtSizeY * sizeof(float));
+            }
+
+            FRandomStream Stream(int32(HashCombine(HashCombine(GetTypeHash(Seed), GetTypeHash(TileIndex)), GetTypeHash(Pass))));
+            for (int32 i = 0; i < Droplets; ++i)
+            {
+                SimulateDroplet(Tile, Stream, Settings);
+            }
+            for (int32 i = 0; i < ThermalSteps; ++i)
+            {
+                RelaxTalus(Tile, MaxTalusDifference, Settings.ThermalRate);
+            }
+
+            for (int32 x = Tile.ExtMin.X; x < Tile.ExtMax.X; ++x)
+            {
+                for (int32 y = Tile.ExtMin.Y; y < Tile.ExtMax.Y; ++y)
+                {
+                    const int32 Local = (x - Tile.ExtMin.X) * ExtSizeY + (y - Tile.ExtMin.Y);
+                    Tile.Delta[Local] = Tile.Heights[Local] - Heights[x * GridSize.Y + y];
+                }
+            }
+        });
+
+        // Halo exchange: each tile gathers the changes overlapping its core from itself and its
+        // neighbours. Cores don't overlap, so tiles can write their own vertices in parallel.
+        RunParallel(Tiles.Num(), NumWorkers, [&](int32 TileIndex)
+        {
+            const FErosionTile& Target = Tiles[TileIndex];
+            const int32 tx = TileIndex / NumTiles.Y;
+            const int32 ty = TileIndex % NumTiles.Y;
+
+            for (int32 sx = FMath::Max(tx - Reach, 0); sx <= FMath::Min(tx + Reach, NumTiles.X - 1); ++sx)
+            {
+                for (int32 sy = FMath::Max(ty - Reach, 0); sy <= FMath::Min(ty + Reach, NumTiles.Y - 1); ++sy)
+                {
+                    const FErosionTile& Source = Tiles[sx * NumTiles.Y + sy];
+                    const int32 SourceSizeY = Source.GetExtSize().Y;
+                    const FIntPoint Min = Target.CoreMin.ComponentMax(Source.ExtMin);
+                    const FIntPoint Max = Target.CoreMax.ComponentMin(Source.ExtMax);
+
+                    for (int32 x = Min.X; x < Max.X; ++x)
+                    {
+                        for (int32 y = Min.Y; y < Max.Y; ++y)
+                        {
+                            Heights[x * GridSize.Y + y] += Source.Delta[(x - Source.ExtMin.X) * SourceSizeY + (y - Source.ExtMin.Y)];
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    for (float& Height : Heights) Height *= CellSize;
+
+    for (const FErosionTile& Tile : Tiles)
+    {
+        Total.Droplets += Tile.Stats.Droplets;
+        Total.DropletSteps += Tile.Stats.DropletSteps;
+        Total.ThermalCellUpdates += Tile.Stats.ThermalCellUpdates;
+    }
+    Total.Seconds = FPlatformTime::Seconds() - StartTime;
+    return Total;
+}
+
+/// | Benchmark | ///
+
+// Erodes a synthetic Perlin heightfield with 1, 2, 4 ... N workers and logs throughput and scaling.
+// Usage: Terrain.BenchmarkErosion [ChunksPerSide=8] [ChunkSize=32]
+static void RunErosionBenchmark(const TArray<FString>& Args)
+{
+    const int32 ChunksPerSide = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 8;
+    const int32 ChunkSize = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 8) : 32;
+    const int32 CellsPerChunk = ChunkSize - 1;
+    const float CellSize = 100.0f;
+
+    const FIntPoint GridSize(ChunksPerSide * CellsPerChunk + 1, ChunksPerSide * CellsPerChunk + 1);
+    TArray<float> SourceHeights;
+    SourceHeights.SetNumUninitialized(GridSize.X * GridSize.Y);
+    for (int32 x = 0; x < GridSize.X; ++x)
+    {
+        for (int32 y = 0; y < GridSize.Y; ++y)
+        {
+            SourceHeights[x * GridSize.Y + y] = FMath::PerlinNoise2D(FVector2D(x, y) * CellSize * 0.0005f) * 500.0f;
+        }
+    }
+
+    const FTerrainErosionSettings Settings;
+    const int32 MaxWorkers = FMath::Max(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1);
+    double SingleWorkerSeconds = 0.0;
+
+    for (int32 Workers = 1; ; Workers = FMath::Min(Workers * 2, MaxWorkers))
+    {
+        TArray<float> Heights = SourceHeights;
+        const FTerrainErosionStats Stats = FTerrainErosion::Erode(Heights, GridSize, CellsPerChunk, CellSize, Settings, 1, Workers);
+        const double Seconds = FMath::Max(Stats.Seconds, 1e-6);
+        if (Workers == 1) SingleWorkerSeconds = Seconds;
+
+        UE_LOG(LogGAM415Project, Display,
+               TEXT("Erosion benchmark %dx%d chunks, %d worker(s): %.1f ms, %.0f droplets/s, %.0f droplet steps/s, %.0f thermal cells/s, x%.2f vs 1 worker"),
+               ChunksPerSide, ChunksPerSide, Workers, Seconds * 1000.0,
+               Stats.Droplets / Seconds, Stats.DropletSteps / Seconds, Stats.ThermalCellUpdates / Seconds,
+               SingleWorkerSeconds / Seconds);
+
+        if (Workers == MaxWorkers) break;
+    }
+}
+
+static FAutoConsoleCommand GErosionBenchmarkCommand(
+    TEXT("Terrain.BenchmarkErosion"),
+    TEXT("Erodes a synthetic heightfield with increasing worker counts and logs iterations/second and scaling. Args: [ChunksPerSide=8] [ChunkSize=32]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunErosionBenchmark));
@@ -0,0 +1,74 @@
+#include "TerrainGenerator.h"
+#include "Hash/CityHash.h"
+#include "Serialization/MemoryWriter.h"
+
+FIntPoint FTerrainGenerationParams::GetNumChunks() const
+{
+    const float ChunkWorldSize = (ChunkSize - 1) * Scale;
+    return FIntPoint(FMath::CeilToInt(XSize / ChunkWorldSize), FMath::CeilToInt(YSize / ChunkWorldSize));
+}
+
+FIntPoint FTerrainGenerationParams::GetHeightfieldSize() const
+{
+    return GetNumChunks() * (ChunkSize - 1) + FIntPoint(1, 1);
+}
+
+uint64 FTerrainGenerationParams::GetCacheKey() const
+{
+    TArray<uint8> KeyData;
+    FMemoryWriter Writer(KeyData);
+
+    FVector2D KeyOrigin = Origin;
+    float KeyXSize = XSize, KeyYSize = YSize, KeyScale = Scale, KeyHeightScale = HeightScale, KeyNoiseScale = NoiseScale;
+    int32 KeyChunkSize = ChunkSize, KeySeed = Seed;
+    bool bKeyErosion = bEnableErosion;
+    FTerrainErosionSettings KeyErosionSettings = ErosionSettings;
+
+    Writer << KeyOrigin << KeyXSize << KeyYSize << KeyScale << KeyHeightScale << KeyNoiseScale << KeyChunkSize << KeySeed;
+    Writer << bKeyErosion;
+    if (bKeyErosion)
+    {
+        Writer << KeyErosionSettings;
+    }
+
+    return CityHash64(reinterpret_cast<const char*>(KeyData.GetData()), KeyData.Num());
+}
+
+FTerrainErosionStats FTerrainGenerator::GenerateHeightfield(const FTerrainGenerationParams& Params, TArray<float>& OutHeights,
+                                                            int32 NumWorkers)
+{
+    const FIntPoint GridSize = Params.GetHeightfieldSize();
+    const FIntPoint NumChunks = Params.GetNumChunks();
+    const FVector2D HalfWorldSize = FVector2D(NumChunks) * ((Params.ChunkSize - 1) * Params.Scale) * 0.5f;
+
+    // Use world space to compute heights using noise.
+    OutHeights.SetNumUninitialized(GridSize.X * GridSize.Y);
+    for (int32 x = 0; x < GridSize.X; x++)
+    {
+        const float WorldPosX = x * Params.Scale - HalfWorldSize.X + Params.Origin.X;
+        for (int32 y = 0; y < GridSize.Y; y++)
+        {
+            const float WorldPosY = y * Params.Scale - HalfWorldSize.Y + Params.Origin.Y;
+            OutHeights[x * GridSize.Y + y] = GetNoiseHeight(Params, WorldPosX, WorldPosY);
+        }
+    }
+
+    if (!Params.bEnableErosion) return FTerrainErosionStats();
+
+    return FTerrainErosion::Erode(OutHeights, GridSize, Params.ChunkSize - 1, Params.Scale,
+                                  Params.ErosionSettings, Params.Seed, NumWorkers);
+}
+
+float FTerrainGenerator::GetNoiseHeight(const FTerrainGenerationParams& Params, float WorldX, float WorldY)
+{
+    return FMath::PerlinNoise2D(FVector2D(WorldX, WorldY) * Params.NoiseScale + GetNoiseOffset(Params.Seed)) * Params.HeightScale;
+}
+
+// Shifts the noise domain by a seed-dependent amount.
+FVector2D FTerrainGenerator::GetNoiseOffset(int32 Seed)
+{
+    if (Seed == 0) return FVector2D::ZeroVector;
+
+    FRandomStream Stream(Seed);
+    return FVector2D(Stream.FRandRange(-1000.0f, 1000.0f), Stream.FRandRange(-1000.0f, 1000.0f));
+}
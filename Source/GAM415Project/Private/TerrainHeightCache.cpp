@@ -0,0 +1,76 @@
+#include "TerrainHeightCache.h"
+#include "GAM415Project.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    // Identifies a terrain height cache file ("THCF").
+    constexpr uint32 CacheMagic = 0x54484346;
+
+    // Bump whenever the file layout or the generation algorithm changes.
+    constexpr int32 CacheVersion = 1;
+}
+
+FString FTerrainHeightCache::GetCacheDirectory()
+{
+    return FPaths::ProjectSavedDir() / TEXT("TerrainCache");
+}
+
+FString FTerrainHeightCache::GetPrebakedDirectory()
+{
+    return FPaths::ProjectContentDir() / TEXT("TerrainCache");
+}
+
+FString FTerrainHeightCache::GetCacheFilename(uint64 Key, bool bPrebaked)
+{
+    return (bPrebaked ? GetPrebakedDirectory() : GetCacheDirectory()) / FString::Printf(TEXT("%016llx.terrain"), Key);
+}
+
+bool FTerrainHeightCache::Load(uint64 Key, const FIntPoint& GridSize, TArray<float>& OutHeights)
+{
+    return LoadFile(GetCacheFilename(Key, true), GridSize, OutHeights) ||
+           LoadFile(GetCacheFilename(Key, false), GridSize, OutHeights);
+}
+
+bool FTerrainHeightCache::LoadFile(const FString& Filename, const FIntPoint& GridSize, TArray<float>& OutHeights)
+{
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *Filename, FILEREAD_Silent)) return false;
+
+    FMemoryReader Reader(Data);
+    uint32 Magic = 0;
+    int32 Version = 0;
+    FIntPoint StoredSize;
+    Reader << Magic << Version << StoredSize;
+
+    if (Magic != CacheMagic || Version != CacheVersion || StoredSize != GridSize)
+    {
+        UE_LOG(LogGAM415Project, Warning, TEXT("Ignoring stale terrain cache %s"), *Filename);
+        return false;
+    }
+
+    OutHeights.BulkSerialize(Reader);
+    return !Reader.IsError() && OutHeights.Num() == GridSize.X * GridSize.Y;
+}
+
+bool FTerrainHeightCache::Save(uint64 Key, const FIntPoint& GridSize, TArray<float>& Heights, bool bPrebaked)
+{
+    TArray<uint8> Data;
+    FMemoryWriter Writer(Data);
+    uint32 Magic = CacheMagic;
+    int32 Version = CacheVersion;
+    FIntPoint StoredSize = GridSize;
+    Writer << Magic << Version << StoredSize;
+    Heights.BulkSerialize(Writer);
+
+    const FString Filename = GetCacheFilename(Key, bPrebaked);
+    if (!FFileHelper::SaveArrayToFile(Data, *Filename))
+    {
+        UE_LOG(LogGAM415Project, Warning, TEXT("Failed to write terrain cache %s"), *Filename);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,466 @@
+#include "TerrainHeightPyramid.h"
+#include "ConvexVolume.h"
+
+namespace
+{
+    // Expands a range so it also covers another range.
+    void IncludeRange(FFloatInterval& Range, const FFloatInterval& Other)
+    {
+        if (Other.IsValid())
+        {
+            Range.Include(Other.Min);
+            Range.Include(Other.Max);
+        }
+    }
+
+    // Clips the segment Start + T * Delta (T in [0, 1]) against a box and returns the entry parameter.
+    bool ClipSegmentToBox(const FVector& Start, const FVector& Delta, const FBox& Box, float& OutEntryT)
+    {
+        float TMin = 0.0f;
+        float TMax = 1.0f;
+
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            // Parallel to this slab: either always inside it or never.
+            if (FMath::IsNearlyZero(Delta[Axis]))
+            {
+                if (Start[Axis] < Box.Min[Axis] || Start[Axis] > Box.Max[Axis]) return false;
+                continue;
+            }
+
+            const float InvDelta = 1.0f / Delta[Axis];
+            float T0 = (Box.Min[Axis] - Start[Axis]) * InvDelta;
+            float T1 = (Box.Max[Axis] - Start[Axis]) * InvDelta;
+            if (T0 > T1) Swap(T0, T1);
+
+            TMin = FMath::Max(TMin, T0);
+            TMax = FMath::Min(TMax, T1);
+            if (TMin > TMax) return false;
+        }
+
+        OutEntryT = TMin;
+        return true;
+    }
+}
+
+void FTerrainHeightPyramid::Init(const FIntPoint& InNumChunks, int32 InChunkSize, float InScale, const FVector2D& InOrigin)
+{
+    Reset();
+
+    NumChunks = InNumChunks;
+    ChunkSize = InChunkSize;
+    Scale = InScale;
+    Origin = InOrigin;
+
+    if (NumChunks.X <= 0 || NumChunks.Y <= 0 || ChunkSize < 2) return;
+
+    // Chunk levels halve the cell grid (rounding up) until a single root node remains.
+    for (int32 Size = ChunkSize - 1; ; Size = (Size + 1) / 2)
+    {
+        ChunkLevelSizes.Add(Size);
+        if (Size == 1) break;
+    }
+
+    // Global levels do the same over the chunk grid.
+    for (FIntPoint Size = NumChunks; ; Size = FIntPoint((Size.X + 1) / 2, (Size.Y + 1) / 2))
+    {
+        GlobalLevelSizes.Add(Size);
+        if (Size.X == 1 && Size.Y == 1) break;
+    }
+
+    Chunks.SetNum(NumChunks.X * NumChunks.Y);
+    for (FChunkLevels& Chunk : Chunks)
+    {
+        Chunk.Heights.SetNumZeroed(ChunkSize * ChunkSize);
+        Chunk.Levels.SetNum(ChunkLevelSizes.Num());
+        for (int32 Level = 0; Level < ChunkLevelSizes.Num(); ++Level)
+        {
+            Chunk.Levels[Level].SetNum(FMath::Square(ChunkLevelSizes[Level]));
+        }
+    }
+
+    GlobalLevels.SetNum(GlobalLevelSizes.Num());
+    for (int32 Level = 0; Level < GlobalLevelSizes.Num(); ++Level)
+    {
+        GlobalLevels[Level].SetNum(GlobalLevelSizes[Level].X * GlobalLevelSizes[Level].Y);
+    }
+}
+
+void FTerrainHeightPyramid::Reset()
+{
+    NumChunks = FIntPoint::ZeroValue;
+    ChunkSize = 0;
+    ChunkLevelSizes.Empty();
+    Chunks.Empty();
+    GlobalLevelSizes.Empty();
+    GlobalLevels.Empty();
+}
+
+void FTerrainHeightPyramid::BuildChunk(int32 ChunkIndex, const TArray<FVector>& Vertices)
+{
+    UpdateChunkRegion(ChunkIndex, Vertices, FIntPoint(0, 0), FIntPoint(ChunkSize - 1, ChunkSize - 1));
+}
+
+void FTerrainHeightPyramid::UpdateChunkRegion(int32 ChunkIndex, const TArray<FVector>& Vertices, FIntPoint MinVertex, FIntPoint MaxVertex)
+{
+    if (!Chunks.IsValidIndex(ChunkIndex) || Vertices.Num() != ChunkSize * ChunkSize) return;
+
+    MinVertex = MinVertex.ComponentMax(FIntPoint(0, 0));
+    MaxVertex = MaxVertex.ComponentMin(FIntPoint(ChunkSize - 1, ChunkSize - 1));
+    if (MinVertex.X > MaxVertex.X || MinVertex.Y > MaxVertex.Y) return;
+
+    FChunkLevels& Chunk = Chunks[ChunkIndex];
+
+    // Copy the changed heights.
+    for (int32 x = MinVertex.X; x <= MaxVertex.X; ++x)
+    {
+        for (int32 y = MinVertex.Y; y <= MaxVertex.Y; ++y)
+        {
+            const int32 Index = x * ChunkSize + y;
+            Chunk.Heights[Index] = Vertices[Index].Z;
+        }
+    }
+
+    // Every cell sharing a changed vertex, then their parents level by level.
+    const int32 LastCell = ChunkSize - 2;
+    FIntPoint MinNode = (MinVertex - FIntPoint(1, 1)).ComponentMax(FIntPoint(0, 0));
+    FIntPoint MaxNode = MaxVertex.ComponentMin(FIntPoint(LastCell, LastCell));
+
+    for (int32 Level = 0; Level < ChunkLevelSizes.Num(); ++Level)
+    {
+        RebuildChunkNodes(Chunk, Level, MinNode, MaxNode);
+        MinNode /= 2;
+        MaxNode /= 2;
+    }
+
+    RefreshGlobalNodes(ChunkIndex);
+}
+
+void FTerrainHeightPyramid::RebuildChunkNodes(FChunkLevels& Chunk, int32 Level, const FIntPoint& MinNode, const FIntPoint& MaxNode) const
+{
+    const int32 Size = ChunkLevelSizes[Level];
+    TArray<FFloatInterval>& Nodes = Chunk.Levels[Level];
+
+    for (int32 x = MinNode.X; x <= MaxNode.X; ++x)
+    {
+        for (int32 y = MinNode.Y; y <= MaxNode.Y; ++y)
+        {
+            FFloatInterval Range;
+
+            if (Level == 0)
+            {
+                // A cell spans its four corner vertices.
+                const int32 Index = x * ChunkSize + y;
+                Range.Include(Chunk.Heights[Index]);
+                Range.Include(Chunk.Heights[Index + 1]);
+                Range.Include(Chunk.Heights[Index + ChunkSize]);
+                Range.Include(Chunk.Heights[Index + ChunkSize + 1]);
+            }
+            else
+            {
+                // A node spans up to four children of the level below.
+                const int32 ChildSize = ChunkLevelSizes[Level - 1];
+                const TArray<FFloatInterval>& Children = Chunk.Levels[Level - 1];
+                for (int32 cx = x * 2; cx <= FMath::Min(x * 2 + 1, ChildSize - 1); ++cx)
+                {
+                    for (int32 cy = y * 2; cy <= FMath::Min(y * 2 + 1, ChildSize - 1); ++cy)
+                    {
+                        IncludeRange(Range, Children[cx * ChildSize + cy]);
+                    }
+                }
+            }
+
+            Nodes[x * Size + y] = Range;
+        }
+    }
+}
+
+void FTerrainHeightPyramid::RefreshGlobalNodes(int32 ChunkIndex)
+{
+    int32 X = ChunkIndex / NumChunks.Y;
+    int32 Y = ChunkIndex % NumChunks.Y;
+
+    // Level 0 mirrors the chunk's root range.
+    GlobalLevels[0][ChunkIndex] = Chunks[ChunkIndex].Levels.Last()[0];
+
+    // Only the single ancestor per level needs recomputing.
+    for (int32 Level = 1; Level < GlobalLevelSizes.Num(); ++Level)
+    {
+        X /= 2;
+        Y /= 2;
+
+        const FIntPoint ChildSize = GlobalLevelSizes[Level - 1];
+        const TArray<FFloatInterval>& Children = GlobalLevels[Level - 1];
+
+        FFloatInterval Range;
+        for (int32 cx = X * 2; cx <= FMath::Min(X * 2 + 1, ChildSize.X - 1); ++cx)
+        {
+            for (int32 cy = Y * 2; cy <= FMath::Min(Y * 2 + 1, ChildSize.Y - 1); ++cy)
+            {
+                IncludeRange(Range, Children[cx * ChildSize.Y + cy]);
+            }
+        }
+
+        GlobalLevels[Level][X * GlobalLevelSizes[Level].Y + Y] = Range;
+    }
+}
+
+FBox FTerrainHeightPyramid::GetGlobalNodeBounds(int32 Level, int32 X, int32 Y, const FFloatInterval& Range) const
+{
+    const float ChunkWorldSize = (ChunkSize - 1) * Scale;
+    const int32 MaxX = FMath::Min((X + 1) << Level, NumChunks.X);
+    const int32 MaxY = FMath::Min((Y + 1) << Level, NumChunks.Y);
+
+    return FBox(FVector(Origin.X + (X << Level) * ChunkWorldSize, Origin.Y + (Y << Level) * ChunkWorldSize, Range.Min),
+                FVector(Origin.X + MaxX * ChunkWorldSize, Origin.Y + MaxY * ChunkWorldSize, Range.Max));
+}
+
+FBox FTerrainHeightPyramid::GetChunkNodeBounds(int32 ChunkIndex, int32 Level, int32 X, int32 Y, const FFloatInterval& Range) const
+{
+    const int32 NumCells = ChunkSize - 1;
+    const FVector2D ChunkMin = Origin + FVector2D(ChunkIndex / NumChunks.Y, ChunkIndex % NumChunks.Y) * (NumCells * Scale);
+    const int32 MaxX = FMath::Min((X + 1) << Level, NumCells);
+    const int32 MaxY = FMath::Min((Y + 1) << Level, NumCells);
+
+    return FBox(FVector(ChunkMin.X + (X << Level) * Scale, ChunkMin.Y + (Y << Level) * Scale, Range.Min),
+                FVector(ChunkMin.X + MaxX * Scale, ChunkMin.Y + MaxY * Scale, Range.Max));
+}
+
+FBox FTerrainHeightPyramid::GetChunkBounds(int32 ChunkIndex) const
+{
+    if (!Chunks.IsValidIndex(ChunkIndex)) return FBox(ForceInit);
+
+    const int32 RootLevel = ChunkLevelSizes.Num() - 1;
+    return GetChunkNodeBounds(ChunkIndex, RootLevel, 0, 0, Chunks[ChunkIndex].Levels[RootLevel][0]);
+}
+
+FFloatInterval FTerrainHeightPyramid::GetHeightRange() const
+{
+    return GlobalLevels.Num() > 0 ? GlobalLevels.Last()[0] : FFloatInterval();
+}
+
+void FTerrainHeightPyramid::GetCellCorners(int32 ChunkIndex, int32 CellX, int32 CellY, FVector OutCorners[4]) const
+{
+    const TArray<float>& Heights = Chunks[ChunkIndex].Heights;
+    const int32 NumCells = ChunkSize - 1;
+    const float BaseX = Origin.X + ((ChunkIndex / NumChunks.Y) * NumCells + CellX) * Scale;
+    const float BaseY = Origin.Y + ((ChunkIndex % NumChunks.Y) * NumCells + CellY) * Scale;
+    const int32 Index = CellX * ChunkSize + CellY;
+
+    OutCorners[0] = FVector(BaseX, BaseY, Heights[Index]);
+    OutCorners[1] = FVector(BaseX, BaseY + Scale, Heights[Index + 1]);
+    OutCorners[2] = FVector(BaseX + Scale, BaseY, Heights[Index + ChunkSize]);
+    OutCorners[3] = FVector(BaseX + Scale, BaseY + Scale, Heights[Index + ChunkSize + 1]);
+}
+
+/// | Queries | ///
+
+bool FTerrainHeightPyramid::GetHeightAt(const FVector2D& Location, float& OutHeight) const
+{
+    if (!IsInitialized()) return false;
+
+    // Position in global grid units.
+    const int32 NumCells = ChunkSize - 1;
+    const FVector2D GridPos = (Location - Origin) / Scale;
+    const FIntPoint GridSize = NumChunks * NumCells;
+
+    if (GridPos.X < 0 || GridPos.Y < 0 || GridPos.X > GridSize.X || GridPos.Y > GridSize.Y) return false;
+
+    const int32 GridX = FMath::Min(FMath::FloorToInt(GridPos.X), GridSize.X - 1);
+    const int32 GridY = FMath::Min(FMath::FloorToInt(GridPos.Y), GridSize.Y - 1);
+    const float FracX = GridPos.X - GridX;
+    const float FracY = GridPos.Y - GridY;
+
+    const int32 ChunkIndex = (GridX / NumCells) * NumChunks.Y + (GridY / NumCells);
+    const TArray<float>& Heights = Chunks[ChunkIndex].Heights;
+    const int32 Index = (GridX % NumCells) * ChunkSize + (GridY % NumCells);
+
+    const float H00 = Heights[Index];
+    const float H01 = Heights[Index + 1];
+    const float H10 = Heights[Index + ChunkSize];
+    const float H11 = Heights[Index + ChunkSize + 1];
+
+    // Cells are split along the (0,0)-(1,1) diagonal, matching the chunk triangles.
+    OutHeight = FracY >= FracX
+        ? H00 + FracY * (H01 - H00) + FracX * (H11 - H01)
+        : H00 + FracX * (H10 - H00) + FracY * (H11 - H10);
+    return true;
+}
+
+bool FTerrainHeightPyramid::Raycast(const FVector& Start, const FVector& End, FVector& OutHitLocation, FVector& OutHitNormal) const
+{
+    const FVector Delta = End - Start;
+    const float Length = Delta.Size();
+    if (!IsInitialized() || Length <= UE_SMALL_NUMBER) return false;
+
+    // Parameter of the closest hit so far; nodes entered beyond it are skipped.
+    float BestT = 1.0f;
+    bool bHit = false;
+
+    VisitCells(
+        [&](const FBox& Bounds)
+        {
+            float EntryT;
+            return ClipSegmentToBox(Start, Delta, Bounds, EntryT) && EntryT <= BestT;
+        },
+        [&](int32 ChunkIndex, int32 CellX, int32 CellY)
+        {
+            FVector Corners[4];
+            GetCellCorners(ChunkIndex, CellX, CellY, Corners);
+
+            const FVector Triangles[2][3] = {{Corners[0], Corners[1], Corners[3]},
+                                             {Corners[3], Corners[2], Corners[0]}};
+
+            for (const FVector (&Triangle)[3] : Triangles)
+            {
+                FVector HitPoint, HitNormal;
+                if (FMath::SegmentTriangleIntersection(Start, Start + Delta * BestT,
+                                                       Triangle[0], Triangle[1], Triangle[2],
+                                                       HitPoint, HitNormal))
+                {
+                    BestT = (HitPoint - Start).Size() / Length;
+                    OutHitLocation = HitPoint;
+                    // Report the upward facing side regardless of the triangle winding.
+                    OutHitNormal = HitNormal.Z < 0 ? -HitNormal.GetSafeNormal() : HitNormal.GetSafeNormal();
+                    bHit = true;
+                }
+            }
+            return true;
+        });
+
+    return bHit;
+}
+
+bool FTerrainHeightPyramid::OverlapSphere(const FVector& Center, float Radius) const
+{
+    if (!IsInitialized() || Radius < 0) return false;
+
+    const float RadiusSq = FMath::Square(Radius);
+    bool bOverlap = false;
+
+    VisitCells(
+        [&](const FBox& Bounds)
+        {
+            return FMath::SphereAABBIntersection(Center, RadiusSq, Bounds);
+        },
+        [&](int32 ChunkIndex, int32 CellX, int32 CellY)
+        {
+            FVector Corners[4];
+            GetCellCorners(ChunkIndex, CellX, CellY, Corners);
+
+            if (FVector::DistSquared(FMath::ClosestPointOnTriangleToPoint(Center, Corners[0], Corners[1], Corners[3]), Center) <= RadiusSq ||
+                FVector::DistSquared(FMath::ClosestPointOnTriangleToPoint(Center, Corners[3], Corners[2], Corners[0]), Center) <= RadiusSq)
+            {
+                bOverlap = true;
+                return false; // Stop at the first overlapping cell
+            }
+            return true;
+        });
+
+    return bOverlap;
+}
+
+void FTerrainHeightPyramid::GetChunksInFrustum(const FConvexVolume& Frustum, const FTransform& LocalToWorld, TArray<int32>& OutChunkIndices) const
+{
+    if (!IsInitialized()) return;
+
+    struct FNode
+    {
+        int32 Level;
+        int32 X;
+        int32 Y;
+        bool bContained;
+    };
+
+    TArray<FNode, TInlineAllocator<64>> Stack;
+    Stack.Add({GlobalLevelSizes.Num() - 1, 0, 0, false});
+
+    while (Stack.Num() > 0)
+    {
+        const FNode Node = Stack.Pop(EAllowShrinking::No);
+        const FFloatInterval& Range = GlobalLevels[Node.Level][Node.X * GlobalLevelSizes[Node.Level].Y + Node.Y];
+        if (!Range.IsValid()) continue;
+
+        // Once a node is fully inside, its whole subtree is visible without further tests.
+        bool bContained = Node.bContained;
+        if (!bContained)
+        {
+            const FBox Bounds = GetGlobalNodeBounds(Node.Level, Node.X, Node.Y, Range).TransformBy(LocalToWorld);
+            if (!Frustum.IntersectBox(Bounds.GetCenter(), Bounds.GetExtent(), bContained)) continue;
+        }
+
+        if (Node.Level == 0)
+        {
+            OutChunkIndices.Add(Node.X * NumChunks.Y + Node.Y);
+            continue;
+        }
+
+        const FIntPoint ChildSize = GlobalLevelSizes[Node.Level - 1];
+        for (int32 cx = Node.X * 2; cx <= FMath::Min(Node.X * 2 + 1, ChildSize.X - 1); ++cx)
+        {
+            for (int32 cy = Node.Y * 2; cy <= FMath::Min(Node.Y * 2 + 1, ChildSize.Y - 1); ++cy)
+            {
+                Stack.Add({Node.Level - 1, cx, cy, bContained});
+            }
+        }
+    }
+}
+
+/// | Traversal | ///
+
+void FTerrainHeightPyramid::VisitCells(TFunctionRef<bool(const FBox&)> ShouldVisit,
+                                       TFunctionRef<bool(int32 ChunkIndex, int32 CellX, int32 CellY)> Visit) const
+{
+    if (!IsInitialized()) return;
+
+    VisitGlobalNode(GlobalLevelSizes.Num() - 1, 0, 0, ShouldVisit, Visit);
+}
+
+bool FTerrainHeightPyramid::VisitGlobalNode(int32 Level, int32 X, int32 Y,
+                                            TFunctionRef<bool(const FBox&)> ShouldVisit,
+                                            TFunctionRef<bool(int32, int32, int32)> Visit) const
+{
+    const FFloatInterval& Range = GlobalLevels[Level][X * GlobalLevelSizes[Level].Y + Y];
+    if (!Range.IsValid() || !ShouldVisit(GetGlobalNodeBounds(Level, X, Y, Range))) return true;
+
+    // Global level 0 nodes are chunks; continue into the chunk's own levels.
+    if (Level == 0)
+    {
+        return VisitChunkNode(X * NumChunks.Y + Y, ChunkLevelSizes.Num() - 1, 0, 0, ShouldVisit, Visit);
+    }
+
+    const FIntPoint ChildSize = GlobalLevelSizes[Level - 1];
+    for (int32 cx = X * 2; cx <= FMath::Min(X * 2 + 1, ChildSize.X - 1); ++cx)
+    {
+        for (int32 cy = Y * 2; cy <= FMath::Min(Y * 2 + 1, ChildSize.Y - 1); ++cy)
+        {
+            if (!VisitGlobalNode(Level - 1, cx, cy, ShouldVisit, Visit)) return false;
+        }
+    }
+    return true;
+}
+
+bool FTerrainHeightPyramid::VisitChunkNode(int32 ChunkIndex, int32 Level, int32 X, int32 Y,
+                                           TFunctionRef<bool(const FBox&)> ShouldVisit,
+                                           TFunctionRef<bool(int32, int32, int32)> Visit) const
+{
+    const FChunkLevels& Chunk = Chunks[ChunkIndex];
+    const int32 Size = ChunkLevelSizes[Level];
+    const FFloatInterval& Range = Chunk.Levels[Level][X * Size + Y];
+    if (!Range.IsValid() || !ShouldVisit(GetChunkNodeBounds(ChunkIndex, Level, X, Y, Range))) return true;
+
+    if (Level == 0)
+    {
+        return Visit(ChunkIndex, X, Y);
+    }
+
+    const int32 ChildSize = ChunkLevelSizes[Level - 1];
+    for (int32 cx = X * 2; cx <= FMath::Min(X * 2 + 1, ChildSize - 1); ++cx)
+    {
+        for (int32 cy = Y * 2; cy <= FMath::Min(Y * 2 + 1, ChildSize - 1); ++cy)
+        {
+            if (!VisitChunkNode(ChunkIndex, Level - 1, cx, cy, ShouldVisit, Visit)) return false;
+        }
+    }
+    return true;
+}
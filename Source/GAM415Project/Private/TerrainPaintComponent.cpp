@@ -0,0 +1,246 @@
+#include "TerrainPaintComponent.h"
+#include "GAM415Project.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Misc/App.h"
+#include "Tasks/Task.h"
+
+UTerrainPaintComponent::UTerrainPaintComponent()
+{
+    // Ticks only while paint is queued or being rasterized.
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UTerrainPaintComponent::Init(const FBox2D& InLocalBounds, UMaterialInstanceDynamic* InMaterial)
+{
+    RasterTask.Wait();
+
+    LocalBounds = InLocalBounds;
+    PaintMaterial = InMaterial;
+
+    // Pick the texel density, capped so the texture stays within MaxResolution.
+    const FVector2D Size = LocalBounds.GetSize();
+    const float Density = FMath::Min(TexelsPerUnit, float(MaxResolution / FMath::Max(Size.GetMax(), 1.0)));
+    Resolution = FIntPoint(FMath::Clamp(FMath::CeilToInt(Size.X * Density), 1, MaxResolution),
+                           FMath::Clamp(FMath::CeilToInt(Size.Y * Density), 1, MaxResolution));
+    NumTiles = FIntPoint(FMath::DivideAndRoundUp(Resolution.X, TileSize), FMath::DivideAndRoundUp(Resolution.Y, TileSize));
+
+    Texels.Init(FColor(0, 0, 0, 0), Resolution.X * Resolution.Y);
+    DirtyTiles.Init(false, NumTiles.X * NumTiles.Y);
+    NumPaintedTexels = 0;
+    PendingStamps.Reset();
+
+    // A cleared layer needs no texture until something is painted.
+    PaintTexture = nullptr;
+    if (PaintMaterial)
+    {
+        PaintMaterial->SetTextureParameterValue("PaintTexture", nullptr);
+        PaintMaterial->SetVectorParameterValue("PaintBounds", FLinearColor(LocalBounds.Min.X, LocalBounds.Min.Y, Size.X, Size.Y));
+    }
+}
+
+void UTerrainPaintComponent::AddPaint(const FVector& WorldLocation, float Radius, const FLinearColor& Color)
+{
+    if (Radius <= 0.0f) return;
+
+    if (Texels.IsEmpty())
+    {
+        UE_LOG(LogGAM415Project, Warning, TEXT("%s: paint dropped, the paint layer was never initialized"), *GetPathName());
+        return;
+    }
+
+    // Convert to texel space through the owner's local space.
+    const FVector LocalLocation = GetOwner() ? GetOwner()->GetActorTransform().InverseTransformPosition(WorldLocation) : WorldLocation;
+    const FVector2D TexelsPerLocalUnit = FVector2D(Resolution) / LocalBounds.GetSize();
+
+    FPaintStamp& Stamp = PendingStamps.AddDefaulted_GetRef();
+    Stamp.Center = FVector2f((FVector2D(LocalLocation) - LocalBounds.Min) * TexelsPerLocalUnit);
+    Stamp.Radius = Radius * TexelsPerLocalUnit.GetMax();
+    Stamp.Color = Color.ToFColor(true);
+    Stamp.Color.A = 255;
+
+    SetComponentTickEnabled(true);
+}
+
+void UTerrainPaintComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    // Last frame's raster usually finished while the frame ran; upload it, then start this frame's.
+    if (!RasterTask.IsCompleted()) return;
+
+    UploadDirtyTiles();
+    LaunchRasterization();
+
+    if (PendingStamps.IsEmpty() && !RasterTask.IsValid())
+    {
+        SetComponentTickEnabled(false);
+    }
+}
+
+void UTerrainPaintComponent::LaunchRasterization()
+{
+    if (PendingStamps.IsEmpty())
+    {
+        RasterTask = UE::Tasks::FTask();
+        return;
+    }
+
+    RasterTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Stamps = MoveTemp(PendingStamps)]()
+    {
+        RasterizeStamps(Stamps);
+    });
+    PendingStamps.Reset();
+}
+
+void UTerrainPaintComponent::RasterizeStamps(const TArray<FPaintStamp>& Stamps)
+{
+    for (const FPaintStamp& Stamp : Stamps)
+    {
+        const int32 MinX = FMath::Max(FMath::FloorToInt(Stamp.Center.X - Stamp.Radius), 0);
+        const int32 MinY = FMath::Max(FMath::FloorToInt(Stamp.Center.Y - Stamp.Radius), 0);
+        const int32 MaxX = FMath::Min(FMath::CeilToInt(Stamp.Center.X + Stamp.Radius), Resolution.X - 1);
+        const int32 MaxY = FMath::Min(FMath::CeilToInt(Stamp.Center.Y + Stamp.Radius), Resolution.Y - 1);
+        if (MinX > MaxX || MinY > MaxY) continue;
+
+        const float RadiusSq = FMath::Square(Stamp.Radius);
+        for (int32 y = MinY; y <= MaxY; y++)
+        {
+            for (int32 x = MinX; x <= MaxX; x++)
+            {
+                const float DistSq = FVector2f::DistSquared(FVector2f(x + 0.5f, y + 0.5f), Stamp.Center);
+                if (DistSq > RadiusSq) continue;
+
+                // Newer paint covers older paint.
+                FColor& Texel = Texels[y * Resolution.X + x];
+                NumPaintedTexels += Texel.A == 0 ? 1 : 0;
+                Texel = Stamp.Color;
+            }
+        }
+
+        // Mark every tile the stamp's rectangle overlaps.
+        for (int32 TileY = MinY / TileSize; TileY <= MaxY / TileSize; TileY++)
+        {
+            for (int32 TileX = MinX / TileSize; TileX <= MaxX / TileSize; TileX++)
+            {
+                DirtyTiles[TileY * NumTiles.X + TileX] = true;
+            }
+        }
+    }
+}
+
+// Copies the dirty tiles into one staging buffer, stacked vertically, and uploads them as
+// one region each in a single texture update.
+void UTerrainPaintComponent::UploadDirtyTiles()
+{
+    if (!FApp::CanEverRender())
+    {
+        DirtyTiles.SetRange(0, DirtyTiles.Num(), false);
+        return;
+    }
+
+    const int32 NumDirty = DirtyTiles.CountSetBits();
+    if (NumDirty == 0) return;
+
+    CreatePaintTexture();
+    if (!PaintTexture) return;
+
+    FColor* Staging = new FColor[NumDirty * TileSize * TileSize];
+    FUpdateTextureRegion2D* Regions = new FUpdateTextureRegion2D[NumDirty];
+
+    int32 RegionIndex = 0;
+    for (TConstSetBitIterator<> It(DirtyTiles); It; ++It)
+    {
+        const int32 TileX = It.GetIndex() % NumTiles.X;
+        const int32 TileY = It.GetIndex() / NumTiles.X;
+        const int32 DestX = TileX * TileSize;
+        const int32 DestY = TileY * TileSize;
+        const int32 Width = FMath::Min(TileSize, Resolution.X - DestX);
+        const int32 Height = FMath::Min(TileSize, Resolution.Y - DestY);
+
+        const int32 SrcY = RegionIndex * TileSize;
+        for (int32 Row = 0; Row < Height; Row++)
+        {
+            FMemory::Memcpy(&Staging[(SrcY + Row) * TileSize], &Texels[(DestY + Row) * Resolution.X + DestX], Width * sizeof(FColor));
+        }
+
+        Regions[RegionIndex++] = FUpdateTextureRegion2D(DestX, DestY, 0, SrcY, Width, Height);
+    }
+    DirtyTiles.SetRange(0, DirtyTiles.Num(), false);
+
+    PaintTexture->UpdateTextureRegions(0, NumDirty, Regions, TileSize * sizeof(FColor), sizeof(FColor),
+                                       reinterpret_cast<uint8*>(Staging),
+                                       [](uint8* SrcData, const FUpdateTextureRegion2D* InRegions)
+    {
+        delete[] reinterpret_cast<FColor*>(SrcData);
+        delete[] InRegions;
+    });
+}
+
+void UTerrainPaintComponent::CreatePaintTexture()
+{
+    if (PaintTexture) return;
+
+    PaintTexture = UTexture2D::CreateTransient(Resolution.X, Resolution.Y, PF_B8G8R8A8, TEXT("TerrainPaint"));
+    if (!PaintTexture) return;
+
+    PaintTexture->SRGB = true;
+    PaintTexture->Filter = TF_Bilinear;
+    PaintTexture->AddressX = TA_Clamp;
+    PaintTexture->AddressY = TA_Clamp;
+    PaintTexture->UpdateResource();
+
+    // Everything painted before the texture existed is in Texels, so upload it all once.
+    DirtyTiles.Init(false, NumTiles.X * NumTiles.Y);
+    for (int32 TileY = 0; TileY < NumTiles.Y; TileY++)
+    {
+        for (int32 TileX = 0; TileX < NumTiles.X; TileX++)
+        {
+            DirtyTiles[TileY * NumTiles.X + TileX] = true;
+        }
+    }
+
+    if (PaintMaterial)
+    {
+        PaintMaterial->SetTextureParameterValue("PaintTexture", PaintTexture);
+    }
+}
+
+void UTerrainPaintComponent::FlushPaint()
+{
+    RasterTask.Wait();
+    LaunchRasterization();
+    RasterTask.Wait();
+}
+
+float UTerrainPaintComponent::GetPaintedFraction()
+{
+    FlushPaint();
+    return Texels.IsEmpty() ? 0.0f : float(double(NumPaintedTexels) / Texels.Num());
+}
+
+float UTerrainPaintComponent::GetColorCoverage(const FLinearColor& Color, float Tolerance)
+{
+    FlushPaint();
+    if (Texels.IsEmpty()) return 0.0f;
+
+    const FColor Target = Color.ToFColor(true);
+    const int32 MaxDelta = FMath::RoundToInt(FMath::Clamp(Tolerance, 0.0f, 1.0f) * 255.0f);
+
+    int64 NumMatching = 0;
+    for (const FColor& Texel : Texels)
+    {
+        NumMatching += Texel.A != 0 &&
+                       FMath::Abs(Texel.R - Target.R) <= MaxDelta &&
+                       FMath::Abs(Texel.G - Target.G) <= MaxDelta &&
+                       FMath::Abs(Texel.B - Target.B) <= MaxDelta;
+    }
+    return float(double(NumMatching) / Texels.Num());
+}
+
+void UTerrainPaintComponent::OnUnregister()
+{
+    RasterTask.Wait();
+    Super::OnUnregister();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if ENABLE_DRAW_DEBUG
+
+class UWorld;
+struct FDigShot;
+struct FHitResult;
+
+// Debug visualization of dig shots, controlled by the Dig.Debug console variable.
+// Mode 1 draws individual shots, capped per frame; mode 2 keeps a decaying heatmap of recent dig
+// locations and draws its hottest cells within a fixed per-frame budget, however many shots land.
+// Compiled out of Shipping and Test builds along with the rest of debug drawing.
+class FDigDebugDraw
+{
+public:
+    // Records a resolved shot. Hit is null if the trace hit nothing.
+    void AddShot(UWorld* World, const FDigShot& Shot, const FHitResult* Hit, bool bDugTerrain);
+
+    // Decays and draws the heatmap, and resets the per-frame shot budget.
+    void Tick(UWorld* World, float DeltaTime);
+
+private:
+    // Accumulated dig activity of one heatmap cell.
+    struct FHeatCell
+    {
+        float Heat = 0.0f;
+        // Height of the latest dig in the cell, so the cell is drawn on the ground.
+        float Z = 0.0f;
+    };
+
+    // Heatmap cells keyed by their XY grid coordinates.
+    TMap<FIntPoint, FHeatCell> HeatCells;
+
+    // Shots drawn individually since the last tick.
+    int32 NumShotsDrawnThisFrame = 0;
+};
+
+#endif // ENABLE_DRAW_DEBUG
@@ -1,9 +1,12 @@
 #pragma once
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "DigShotSubsystem.h"
 #include "DigProjectile.generated.h"
 
 // Actor class that fires a trace that can "dig" through an AProceduralTerrain instance.
+// Kept as a Blueprint-facing wrapper; the shot itself runs through UDigShotSubsystem, which
+// weapons can also call directly to avoid spawning an actor per shot.
 UCLASS()
 class GAM415PROJECT_API ADigProjectile : public AActor
 {
@@ -26,6 +29,14 @@ public:
     UPROPERTY(EditAnywhere, Category = "Digging")
     float MaxDistance = 10000.0f;
 
+    // Line digs a crater at the hit; Sweep and Penetrate carve a trench or tunnel StrokeLength long.
+    UPROPERTY(EditAnywhere, Category = "Digging")
+    EDigShotType ShotType = EDigShotType::Line;
+
+    // Length of the trench or tunnel carved past the first contact.
+    UPROPERTY(EditAnywhere, Category = "Digging", meta = (EditCondition = "ShotType != EDigShotType::Line"))
+    float StrokeLength = 1000.0f;
+
     // "Fires" the projectile by doing a line trace from a start location in a specified direction.
     void Fire(const FVector& StartLocation, const FVector& Direction);
 
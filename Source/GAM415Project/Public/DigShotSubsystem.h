@@ -0,0 +1,147 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "DigDebugDraw.h"
+#include "DigShotSubsystem.generated.h"
+
+class AProceduralTerrain;
+
+// How a dig shot meets the terrain.
+UENUM(BlueprintType)
+enum class EDigShotType : uint8
+{
+    // Thin line trace; digs one crater at the first hit.
+    Line,
+    // Sweeps a sphere of DigRadius; at first contact carves a trench StrokeLength long along the surface.
+    Sweep,
+    // Line trace that keeps going StrokeLength units into the terrain past the hit, carving a tunnel.
+    Penetrate
+};
+
+// A single dig shot. Plain data, so firing one costs a trace instead of an actor lifetime.
+USTRUCT(BlueprintType)
+struct FDigShot
+{
+    GENERATED_BODY()
+
+    // Where the trace starts.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Digging")
+    FVector Start = FVector::ZeroVector;
+
+    // Normalized trace direction.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Digging")
+    FVector Direction = FVector::ForwardVector;
+
+    // The radius around the hit point where terrain will be modified.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Digging")
+    float DigRadius = 200.0f;
+
+    // The strength with which the terrain is modified (e.g., how much material is removed).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Digging")
+    float DigStrength = 125.0f;
+
+    // Maximum distance the trace will cover.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Digging")
+    float MaxDistance = 10000.0f;
+
+    // Shape of the trace and the dig.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Digging")
+    EDigShotType Type = EDigShotType::Line;
+
+    // Length of the trench or tunnel carved past the first contact by Sweep and Penetrate shots.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Digging", meta = (EditCondition = "Type != EDigShotType::Line"))
+    float StrokeLength = 1000.0f;
+
+    // Actor the trace ignores, usually the shooter.
+    UPROPERTY(BlueprintReadWrite, Category = "Digging")
+    TWeakObjectPtr<AActor> IgnoredActor;
+};
+
+// Executes dig shots for a world without spawning an actor per shot.
+// Shots can be fired immediately (synchronous trace) or queued: queued shots are traced by the
+// async trace system alongside the rest of the frame, and their digs are applied next tick with
+// one mesh update per touched terrain chunk.
+UCLASS()
+class GAM415PROJECT_API UDigShotSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Dig shots only happen in game worlds.
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Traces a shot and digs into any AProceduralTerrain it hits.
+    UFUNCTION(BlueprintCallable, Category = "Digging")
+    void FireShot(const FDigShot& Shot);
+
+    // Convenience overload for Blueprints and weapons that don't build a record themselves.
+    UFUNCTION(BlueprintCallable, Category = "Digging")
+    void FireDigShot(const FVector& Start, const FVector& Direction, float DigRadius = 200.0f,
+                     float DigStrength = 125.0f, float MaxDistance = 10000.0f, AActor* IgnoredActor = nullptr);
+
+    // Fires several shots at once, e.g. for shotgun-style weapons.
+    void FireShots(TConstArrayView<FDigShot> Shots);
+
+    // Queues a shot on the async trace system; its dig is applied on the next tick.
+    // Meant for automatic and shotgun-style fire, where many shots land per frame.
+    UFUNCTION(BlueprintCallable, Category = "Digging")
+    void QueueShot(const FDigShot& Shot);
+
+    // Queues several shots at once.
+    void QueueShots(TConstArrayView<FDigShot> Shots);
+
+    // Number of shots fired since the world started, including resolved queued shots.
+    int64 GetNumShotsFired() const { return NumShotsFired; }
+
+    // Number of queued shots still waiting for their trace results.
+    int32 GetNumPendingShots() const { return PendingShots.Num(); }
+
+    // Number of queued shots discarded because their trace results expired before a tick read them.
+    int64 GetNumShotsDropped() const { return NumShotsDropped; }
+
+    // Game thread time spent resolving queued shots since the world started.
+    double GetResolveSeconds() const { return ResolveSeconds; }
+
+private:
+    // A queued shot and the handle of its async trace.
+    struct FPendingShot
+    {
+        FDigShot Shot;
+        FTraceHandle TraceHandle;
+    };
+
+    // Applies the dig of a shot whose trace has finished. Terrains are put into a modification
+    // batch on first touch and added to BatchedTerrains, so the caller can end the batches.
+    void ApplyShotHit(const FDigShot& Shot, const FHitResult* Hit, TArray<AProceduralTerrain*>& BatchedTerrains);
+
+    // Ends the modification batches opened by ApplyShotHit, uploading each touched chunk once.
+    static void EndTerrainBatches(TArray<AProceduralTerrain*>& BatchedTerrains);
+
+    // Traces a shot synchronously. Sweep shots use a sphere of DigRadius.
+    bool TraceShot(const FDigShot& Shot, FHitResult& OutHit) const;
+
+    // Builds the query params for a shot.
+    static FCollisionQueryParams MakeQueryParams(const FDigShot& Shot);
+
+    // Shots waiting for their async trace, in the order they were queued.
+    TArray<FPendingShot> PendingShots;
+
+    // Reused across ticks to avoid allocating.
+    TArray<AProceduralTerrain*> TickBatchedTerrains;
+
+    int64 NumShotsFired = 0;
+
+    int64 NumShotsDropped = 0;
+
+    double ResolveSeconds = 0.0;
+
+#if ENABLE_DRAW_DEBUG
+    // Per-shot lines and the dig heatmap, see Dig.Debug.
+    FDigDebugDraw DebugDraw;
+#endif
+};
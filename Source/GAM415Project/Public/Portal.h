@@ -2,11 +2,79 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "ConvexVolume.h"
+#include "UObject/ObjectKey.h"
+#include "Engine/TextureRenderTarget2D.h"
 #include "Portal.generated.h"
 
 class UStaticMeshComponent;
 class USceneCaptureComponent2D;
 class UMaterialInstanceDynamic;
+class APlayerController;
+
+// Player camera data portals decide their captures from
+struct FPortalView
+{
+    TWeakObjectPtr<APlayerController> PlayerController;
+
+    // Local player index, which picks the portal's capture for this view
+    int32 ViewIndex = 0;
+
+    FVector Location = FVector::ZeroVector;
+    FRotator Rotation = FRotator::ZeroRotator;
+    float FOV = 90.0f;
+
+    // Size of the player's view in pixels, its split-screen share of the viewport when split
+    FVector2D ViewSize = FVector2D(1920.0, 1080.0);
+
+    // World space view frustum, when the player has a viewport to project with
+    FConvexVolume Frustum;
+    bool bHasFrustum = false;
+};
+
+// Why a portal can be seen or not from a view
+enum class EPortalVisibility : uint8
+{
+    Visible,
+    TooFar,
+    BackFacing,
+    NotRendered,
+    OutsideFrustum,
+};
+
+// A portal's capture for one local player. Each player sees the portal through its own surface,
+// hidden from the other players, so split-screen views never show another player's capture.
+USTRUCT()
+struct FPortalViewCapture
+{
+    GENERATED_BODY()
+
+    // Capture rendering this player's view; the portal's own SceneCapture for the first player
+    UPROPERTY()
+    TObjectPtr<USceneCaptureComponent2D> SceneCapture;
+
+    // Surface only this player sees; the portal's own PortalMesh for the first player
+    UPROPERTY()
+    TObjectPtr<UStaticMeshComponent> Surface;
+
+    // Material on Surface showing this capture
+    UPROPERTY()
+    TObjectPtr<UMaterialInstanceDynamic> Material;
+
+    TWeakObjectPtr<APlayerController> PlayerController;
+
+    // Current render target size as a fraction of the player's view
+    float RenderTargetScale = 1.0f;
+
+    // Time the capture has wanted a smaller render target
+    float ScaleDownTimer = 0.0f;
+
+    uint64 LastCaptureFrame = 0;
+    double LastCaptureTime = -1.0;
+
+    // World time the portal was last seen by this player, captured or not
+    double LastVisibleTime = 0.0;
+};
 
 UCLASS()
 class GAM415PROJECT_API APortal : public AActor
@@ -32,20 +100,127 @@ public:
     UPROPERTY(EditInstanceOnly, Category = "Portal")
     TSoftObjectPtr<APortal> LinkedPortal;
 
-    // Enables view clipping through the portal plane to prevent seeing behind
+    // Starts the portal view at the linked portal's surface with an oblique near plane, so objects
+    // behind the linked portal never block the view
     UPROPERTY(EditInstanceOnly, Category = "Portal")
     bool bShouldClipPlane = true;
 
+    /// | Render Target Scaling | ///
+
+    // Smallest render target size, as a fraction of the viewport
+    UPROPERTY(EditAnywhere, Category = "Portal|Render Target", meta = (ClampMin = "0.05", ClampMax = "1.0"))
+    float MinRenderTargetScale = 0.25f;
+
+    // Largest render target size, as a fraction of the viewport
+    UPROPERTY(EditAnywhere, Category = "Portal|Render Target", meta = (ClampMin = "0.05", ClampMax = "1.0"))
+    float MaxRenderTargetScale = 1.0f;
+
+    // Scales the render target snaps to, so it is only reallocated when crossing a step
+    UPROPERTY(EditAnywhere, Category = "Portal|Render Target")
+    TArray<float> RenderTargetScaleSteps;
+
+    // How far below the current step the portal's screen size must drop before scaling down
+    UPROPERTY(EditAnywhere, Category = "Portal|Render Target", meta = (ClampMin = "0.0", ClampMax = "0.9"))
+    float ScaleDownHysteresis = 0.15f;
+
+    // Seconds the portal must stay small before its render target scales down
+    UPROPERTY(EditAnywhere, Category = "Portal|Render Target", meta = (ClampMin = "0.0"))
+    float ScaleDownDelay = 0.5f;
+
+    // Seconds the portal must stay hidden before its render target goes back to the pool
+    UPROPERTY(EditAnywhere, Category = "Portal|Render Target", meta = (ClampMin = "0.0"))
+    float RenderTargetReleaseDelay = 1.0f;
+
+    // Pixel format of the render target; portals sharing a format share pooled targets
+    UPROPERTY(EditAnywhere, Category = "Portal|Render Target")
+    TEnumAsByte<ETextureRenderTargetFormat> RenderTargetFormat = RTF_RGBA16f;
+
+    /// | Recursion | ///
+
+    // Number of times the portal can be seen through itself, including the direct view (1 = no recursion)
+    UPROPERTY(EditAnywhere, Category = "Portal|Recursion", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 MaxRecursionDepth = 3;
+
+    // Render target scale of each recursion level relative to the level above
+    UPROPERTY(EditAnywhere, Category = "Portal|Recursion", meta = (ClampMin = "0.1", ClampMax = "1.0"))
+    float RecursionResolutionScale = 0.5f;
+
+    // Recursion stops once the recursive view would cover less than this fraction of the screen
+    UPROPERTY(EditAnywhere, Category = "Portal|Recursion", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float MinRecursionFootprint = 0.05f;
+
+    /// | Capture Culling | ///
+
+    // Portals farther than this from the camera stop capturing (0 = no limit)
+    UPROPERTY(EditAnywhere, Category = "Portal|Culling", meta = (ClampMin = "0.0"))
+    float MaxCaptureDistance = 20000.0f;
+
+    // Portals whose surface was not drawn within this many seconds stop capturing
+    UPROPERTY(EditAnywhere, Category = "Portal|Culling", meta = (ClampMin = "0.0"))
+    float RecentlyRenderedTolerance = 0.2f;
+
+    /// | Teleportation | ///
+
+    // Seconds both portals ignore an actor after teleporting it, so it does not bounce straight back
+    UPROPERTY(EditAnywhere, Category = "Portal|Teleport", meta = (ClampMin = "0.0"))
+    float TeleportCooldown = 0.2f;
+
     /// | Portal Functionality | ///
     
     // Sets the linked portal and establishes bidirectional relationship
     UFUNCTION(BlueprintCallable, Category = "Portal")
     void SetLinkedPortal(APortal* NewPortal);
 
-    virtual void Tick(float DeltaTime) override;
+    // Rotation part of a view matrix, including the swap to the Z-forward axes projections use
+    static FMatrix GetViewRotationMatrix(const FRotator& Rotation);
+
+    // Perspective projection for a view of Size pixels whose near plane lies on ClipPlane (world
+    // space, kept where PlaneDot > 0). Returns the plain projection when the camera is past the plane.
+    static FMatrix MakeObliqueProjection(const FVector& ViewLocation, const FRotator& ViewRotation, float FOV,
+                                         const FIntPoint& Size, const FPlane& ClipPlane);
+
+    // Gathers a player's camera data for portal captures. Returns false without a camera.
+    static bool GetPlayerView(const APlayerController* PlayerController, FPortalView& OutView);
+
+    // Tests distance, facing, last render time of the view's surface and the view frustum, cheapest
+    // first. bCheckRendered = false skips the render time test, which never passes without a renderer.
+    EPortalVisibility GetVisibility(const FPortalView& View, bool bCheckRendered = true) const;
+
+    // Fraction of the view the portal spans along its wider screen axis (0-1)
+    float GetScreenCoverage(const FPortalView& View) const;
+
+    // Renders the linked portal's view as seen from View, recursing through this portal at most
+    // MaxRecursiveCaptures extra times. Returns the number of recursive captures issued.
+    int32 CaptureView(const FPortalView& View, int32 MaxRecursiveCaptures);
+
+    // Counts a capture for View skipped for a visibility reason
+    void RecordSkippedCapture(const FPortalView& View, EPortalVisibility Reason);
+
+    // Counts a capture for View that the budget pushed to a later frame
+    void RecordDeferredCapture(const FPortalView& View);
+
+    bool HasLinkedPortal() const { return LinkedPortal.IsValid(); }
+
+    // Fraction of the way from Start to End at which a sphere of Radius first touches the portal's
+    // front within its surface. Projectiles simulated without actors raise no overlap events, so
+    // they test this instead. Reads no other actor, so it is safe from parallel sweeps.
+    bool FindEntry(const FVector& Start, const FVector& End, float Radius, float& OutTime) const;
+
+    // Moves a location and velocity that entered this portal out of the linked portal
+    void TransformThroughPortal(FVector& Location, FVector& Velocity) const;
+
+    // Frame of the last capture for View, 0 before the first
+    uint64 GetLastCaptureFrame(const FPortalView& View) const;
+
+    // Captures issued, skipped and deferred since the portal started
+    int32 GetNumCaptures() const { return NumCaptures; }
+    int32 GetNumSkippedCaptures() const { return NumSkippedCaptures; }
+    int32 GetNumSkippedCaptures(EPortalVisibility Reason) const { return NumSkippedByReason[uint8(Reason)]; }
+    int32 GetNumDeferredCaptures() const { return NumDeferredCaptures; }
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
     /// | Dynamic material instance for the portal surface | ///
@@ -60,8 +235,14 @@ private:
                         UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, 
                         bool bFromSweep, const FHitResult& SweepResult);
 
+    // Whether an actor may pass through: movable, not attached to another actor and not cooling down
+    bool CanTeleport(const AActor* Actor) const;
+
     // Main teleportation logic controller
-    void HandleTeleportation(APawn* Pawn);
+    void HandleTeleportation(AActor* Actor, const FVector& Velocity);
+
+    // Ignores an actor until the given world time
+    void StartTeleportCooldown(const AActor* Actor, double EndTime);
     
     // Calculates new position after teleportation
     FVector CalculateTeleportLocation(const AActor* TeleportingActor) const;
@@ -75,36 +256,56 @@ private:
     // Transforms velocity through portal connection
     FVector CalculateTeleportVelocity(const FVector& OldVelocity) const;
     
-    // Gets current velocity from movement component or physics
-    FVector GetTeleportVelocity(const APawn* Pawn) const;
+    // Gets current velocity from physics or the movement component
+    static FVector GetTeleportVelocity(const AActor* Actor);
     
+    // Normal of the side the surface is seen from and entered through: behind the forward vector
+    FVector GetFrontNormal() const { return -GetActorForwardVector(); }
+
     // Determines if actor approached from front-facing direction
     bool IsFrontFacing(const FVector& ImpactNormal) const;
+
+    // Determines if an actor moved without a sweep is heading into the front of the portal
+    bool IsMovingIntoFront(const FVector& Velocity) const;
     
-    // Applies transformed velocity to pawn
-    void ApplyTeleportVelocity(APawn* Pawn, const FVector& NewVelocity) const;
+    // Applies transformed velocity, and spin for physics bodies, to the actor
+    void ApplyTeleportVelocity(AActor* Actor, const FVector& NewVelocity) const;
 
     /// | Scene Capture System | ///
     
     // Initializes scene capture components and render target
     void InitializeSceneCapture();
+
+    // Returns the capture of View's player, creating its surface and scene capture on first use
+    FPortalViewCapture& FindOrAddViewCapture(const FPortalView& View);
+
+    // Hides every view surface from the local players it does not belong to
+    void HideOtherViewSurfaces();
     
-    // Updates capture transform to match player perspective
-    void UpdateSceneCapture();
-    
-    // Configures clipping plane for portal view
-    void ConfigureClipPlane();
-    
-    // Adjusts render target to match viewport resolution
-    void UpdateRenderTargetSize();
+    // Resizes a view's render target to the portal's quantized screen size
+    void UpdateRenderTargetSize(FPortalViewCapture& ViewCapture, const FPortalView& View, float DeltaTime);
+
+    // Returns a view's render target to UPortalSubsystem's pool
+    void ReleaseRenderTarget(FPortalViewCapture& ViewCapture);
+
+    // Picks the render target scale step for a screen coverage, within the min/max clamps
+    float SelectRenderTargetScale(float ScreenCoverage) const;
     
-    // Positions scene capture to simulate linked portal view
-    void UpdateSceneCaptureTransform(const FVector& CameraLocation,
+    // Positions a scene capture to simulate linked portal view
+    void UpdateSceneCaptureTransform(USceneCaptureComponent2D* Capture,
+                                     const FVector& CameraLocation,
                                      const FRotator& CameraRotation,
                                      float CameraFOV);
     
+    // Moves a camera through the portal to where it looks out of the linked portal
+    void TransformViewThroughPortal(FVector& Location, FRotator& Rotation) const;
+
+    // Fraction of a camera's view a box spans along its wider screen axis (0-1)
+    static float GetCoverageFromCamera(const FBox& Bounds, const FVector& Location, const FRotator& Rotation,
+                                       float FOV, const FVector2D& ViewSize);
+
     // Gets current viewport resolution
-    FVector2D GetViewportSize() const;
+    static FVector2D GetViewportSize();
     
     // Initializes portal surface material
     void InitializePortalMaterial();
@@ -128,9 +329,24 @@ private:
 
     /// | Teleportation State Management | ///
     
-    // Actors currently ignoring portal collisions
-    TArray<TWeakObjectPtr<AActor>> IgnoredActors;
-    
-    // Timer handle for teleportation cooldown
-    FTimerHandle IgnoreTimerHandle;
+    // World time until which each recently teleported actor is ignored
+    TMap<FObjectKey, double> TeleportCooldowns;
+
+    // Size of TeleportCooldowns at which expired entries are next removed
+    int32 NextCooldownPrune = 16;
+
+    /// | View Capture State | ///
+
+    // Capture of each local player, indexed by FPortalView::ViewIndex
+    UPROPERTY()
+    TArray<FPortalViewCapture> ViewCaptures;
+
+    /// | Capture Statistics | ///
+
+    int32 NumCaptures = 0;
+    int32 NumSkippedCaptures = 0;
+    int32 NumDeferredCaptures = 0;
+
+    // Skipped captures per EPortalVisibility reason
+    int32 NumSkippedByReason[uint8(EPortalVisibility::OutsideFrustum) + 1] = {};
 };
\ No newline at end of file
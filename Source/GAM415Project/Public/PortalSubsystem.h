@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Portal.h"
+#include "PortalSubsystem.generated.h"
+
+class APortal;
+class UTextureRenderTarget2D;
+
+// Decides which portals capture each frame. Every local player's camera is read once per frame,
+// and each portal is captured separately for each split-screen view it can be seen in. Visible
+// (portal, view) pairs are ranked by screen coverage: the top Portal.FullRateCaptures capture every
+// frame; the rest share Portal.RoundRobinCaptures captures per frame, least recently captured first. Recursive views of portals seen through
+// themselves share Portal.RecursionBudget extra captures per frame. Capture cost per frame is therefore bounded
+// however many portals a level places. Portals borrow their render targets from a pool here, so
+// render target memory follows the number of visible portals rather than placed ones.
+UCLASS()
+class GAM415PROJECT_API UPortalSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Portals only capture in game worlds.
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    void RegisterPortal(APortal* Portal);
+    void UnregisterPortal(APortal* Portal);
+
+    const TArray<TObjectPtr<APortal>>& GetPortals() const { return Portals; }
+
+    // Ticks with these views in place of the local players' cameras until cleared, e.g. to test
+    // culling headless. bInCheckRendered = false skips the render time test, which never passes
+    // without a renderer.
+    void SetViewOverride(TConstArrayView<FPortalView> InViews, bool bInCheckRendered);
+    void ClearViewOverride();
+
+    // Lends a render target of the given size and format, reusing a returned one when possible.
+    UTextureRenderTarget2D* AcquireRenderTarget(const FIntPoint& Size, ETextureRenderTargetFormat Format);
+
+    // Takes a render target back for reuse. Beyond Portal.RenderTargetPoolSize free targets, the
+    // longest unused one is dropped.
+    void ReleaseRenderTarget(UTextureRenderTarget2D* RenderTarget);
+
+    // Render targets currently lent to portals, and waiting in the pool.
+    int32 GetNumLentRenderTargets() const { return NumLentRenderTargets; }
+    int32 GetNumFreeRenderTargets() const { return FreeRenderTargets.Num(); }
+
+private:
+    // A portal visible in one of the views and its share of that view this frame.
+    struct FPortalCandidate
+    {
+        APortal* Portal;
+        int32 ViewSlot;
+        float ScreenCoverage;
+    };
+
+    // Every portal that has begun play.
+    UPROPERTY()
+    TArray<TObjectPtr<APortal>> Portals;
+
+    // Local player views of the current frame. Scratch space reused every tick.
+    TArray<FPortalView, TInlineAllocator<4>> Views;
+
+    // Views used instead of the local players' while bOverrideViews is set.
+    TArray<FPortalView> OverrideViews;
+    bool bOverrideViews = false;
+    bool bCheckRendered = true;
+
+    // Visible portals of the current frame, indexing into Views. Scratch space reused every tick.
+    TArray<FPortalCandidate> Candidates;
+
+    // Render targets not lent to any portal, oldest release first.
+    UPROPERTY()
+    TArray<TObjectPtr<UTextureRenderTarget2D>> FreeRenderTargets;
+
+    int32 NumLentRenderTargets = 0;
+};
@@ -3,8 +3,24 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "ProceduralMeshComponent.h"
+#include "TerrainErosion.h"
+#include "TerrainGenerator.h"
+#include "TerrainHeightPyramid.h"
+#include "TerrainPaintComponent.h"
 #include "ProceduralTerrain.generated.h"
 
+struct FConvexVolume;
+
+// Material layers blended through the terrain's vertex colors (R, G, B, A).
+UENUM(BlueprintType)
+enum class ETerrainLayer : uint8
+{
+    Grass,
+    Rock,
+    Snow,
+    Dirt
+};
+
 // Structure to store data for each terrain chunk section.
 USTRUCT()
 struct FChunkData
@@ -23,6 +39,11 @@ struct FChunkData
     UPROPERTY()
     TArray<int32> Triangles;
 
+    // Per-vertex material layer weights, one byte per ETerrainLayer, summing to 255.
+    // Uploaded as the section's vertex colors.
+    UPROPERTY()
+    TArray<FColor> LayerWeights;
+
     // 2D bounds of the chunk (min corner in world coordinates)
     UPROPERTY()
     FVector2D MinBounds;
@@ -30,6 +51,12 @@ struct FChunkData
     // 2D bounds of the chunk (max corner in world coordinates)
     UPROPERTY()
     FVector2D MaxBounds;
+
+    // Vertex positions changed since the last upload.
+    bool bGeometryDirty = false;
+
+    // Layer weights changed since the last upload.
+    bool bLayersDirty = false;
 };
 
 // Actor class responsible for generating and managing procedural terrain using one procedural mesh component
@@ -44,6 +71,9 @@ public:
     // Called when properties are changed in editor or actor is spawned.
     virtual void OnConstruction(const FTransform& Transform) override;
 
+    // Restores the in-memory terrain state when construction did not run this session.
+    virtual void BeginPlay() override;
+
     // Terrain parameters that define overall size and appearance.
     UPROPERTY(EditAnywhere, Category = "Terrain", meta = (ClampMin = "1.0"))
     float XSize = 10000.0f;
@@ -63,10 +93,37 @@ public:
     UPROPERTY(EditAnywhere, Category = "Terrain", meta = (ClampMin = "0.0001"))
     float NoiseScale = 0.0005f;
 
+    // Offsets the noise so different seeds give different terrain. 0 keeps the unseeded layout.
+    UPROPERTY(EditAnywhere, Category = "Terrain")
+    int32 Seed = 0;
+
     // Parameters for chunking the terrain.
     UPROPERTY(EditAnywhere, Category = "Chunking", meta = (ClampMin = "8"))
     int32 ChunkSize = 32;
 
+    // Runs hydraulic and thermal erosion over the generated heights.
+    UPROPERTY(EditAnywhere, Category = "Erosion")
+    bool bEnableErosion = false;
+
+    // Stores eroded heights on disk keyed by seed and parameters, so erosion only runs once.
+    UPROPERTY(EditAnywhere, Category = "Erosion", meta = (EditCondition = "bEnableErosion"))
+    bool bCacheErosion = true;
+
+    UPROPERTY(EditAnywhere, Category = "Erosion", meta = (EditCondition = "bEnableErosion"))
+    FTerrainErosionSettings ErosionSettings;
+
+    // Slope range (degrees) over which the rock layer blends in.
+    UPROPERTY(EditAnywhere, Category = "Layers")
+    FVector2D RockSlopeRange = FVector2D(30.0f, 45.0f);
+
+    // Height range over which the snow layer blends in on ground that isn't rock.
+    UPROPERTY(EditAnywhere, Category = "Layers")
+    FVector2D SnowHeightRange = FVector2D(250.0f, 400.0f);
+
+    // How strongly digging exposes the dirt layer at the center of a dig.
+    UPROPERTY(EditAnywhere, Category = "Layers", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float DigDirtStrength = 1.0f;
+
     // Material used to render the terrain.
     UPROPERTY(EditAnywhere, Category = "Material")
     UMaterialInterface* TerrainMaterial;
@@ -75,10 +132,59 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Terrain")
     void ModifyTerrainAtLocation(const FVector& DigLocation, float DigRadius = 200.0f, float DigStrength = 125.0f);
 
+    // Carves a capsule of DigRadius around the segment out of the terrain as one brush stroke:
+    // vertices under the capsule are lowered to its bottom, by at most DigStrength. Every touched
+    // chunk is updated once, however long the segment is.
+    UFUNCTION(BlueprintCallable, Category = "Terrain")
+    void ModifyTerrainAlongSegment(const FVector& Start, const FVector& End, float DigRadius = 200.0f, float DigStrength = 125.0f);
+
+    // Blends a material layer into the vertex layer weights around a location.
+    UFUNCTION(BlueprintCallable, Category = "Terrain")
+    void PaintTerrainLayerAtLocation(const FVector& Location, ETerrainLayer Layer, float Radius = 200.0f, float Strength = 1.0f);
+
+    // Defers mesh updates until the matching EndModificationBatch, so several modifications in a row
+    // (e.g. all dig hits of a frame) recalculate and upload each touched chunk only once. Batches nest.
+    void BeginModificationBatch();
+
+    // Ends a batch started with BeginModificationBatch; the outermost one uploads all dirty chunks.
+    void EndModificationBatch();
+
+    /// | Terrain Queries | ///
+    // These are answered by the height pyramid and take world space positions.
+
+    // Gets the surface height below/above a location. Returns false outside the terrain.
+    UFUNCTION(BlueprintCallable, Category = "Terrain|Queries")
+    bool GetTerrainHeightAtLocation(const FVector& Location, float& OutHeight) const;
+
+    // Finds the closest point where the segment hits the terrain surface.
+    UFUNCTION(BlueprintCallable, Category = "Terrain|Queries")
+    bool RaycastTerrain(const FVector& Start, const FVector& End, FVector& OutHitLocation, FVector& OutHitNormal) const;
+
+    // Checks whether any part of the terrain surface lies inside the sphere.
+    UFUNCTION(BlueprintCallable, Category = "Terrain|Queries")
+    bool TerrainOverlapsSphere(const FVector& Center, float Radius) const;
+
+    // Collects the mesh section indices of the chunks intersecting a view frustum.
+    void GetVisibleChunkSections(const FConvexVolume& ViewFrustum, TArray<int32>& OutSectionIndices) const;
+
+    // Everything that shapes this terrain's heights, as used by the generator and the bake commandlet.
+    FTerrainGenerationParams GetGenerationParams() const;
+
+    // Persistent paint over the terrain. TerrainMaterial can show it by sampling "PaintTexture" at
+    // (actor-local XY - PaintBounds.xy) / PaintBounds.zw.
+    UTerrainPaintComponent* GetPaintLayer() const { return PaintLayer; }
+
+    // Read access to the acceleration structure over the chunk heights.
+    const FTerrainHeightPyramid& GetHeightPyramid() const { return HeightPyramid; }
+
 protected:
     // Generates the entire terrain. Called from OnConstruction.
     void GenerateTerrain();
 
+    // Rebuilds the height pyramid, material instance and paint layer from the saved chunks, for
+    // placed terrain whose OnConstruction did not run (cooked builds, PIE). Keeps what already exists.
+    void RestoreRuntimeState();
+
     // Clears all current terrain chunk sections from the procedural mesh component.
     void ClearChunks();
 
@@ -87,20 +193,77 @@ private:
     UPROPERTY()
     UProceduralMeshComponent* ProceduralMesh;
 
+    // Paint layer accumulating splats that hit the terrain.
+    UPROPERTY(VisibleAnywhere, Category = "Paint")
+    UTerrainPaintComponent* PaintLayer;
+
+    // Instance of TerrainMaterial shared by every chunk section.
+    UPROPERTY(Transient)
+    UMaterialInstanceDynamic* TerrainMaterialInstance;
+
     // Array storing data for each generated chunk section.
     UPROPERTY()
     TArray<FChunkData> Chunks;
 
-    // Helper function to determine height using Perlin noise.
-    float GetHeightAtWorldPosition(float WorldX, float WorldY) const;
+    // Number of chunks generated along X and Y.
+    UPROPERTY()
+    FIntPoint NumChunks = FIntPoint::ZeroValue;
+
+    // Min/max height pyramid over all chunks, kept in sync with every modification.
+    FTerrainHeightPyramid HeightPyramid;
+
+    // Chunks waiting for FlushDirtyChunks to upload them.
+    TArray<int32> DirtyChunks;
+
+    // Number of open modification batches; dirty chunks are flushed only when it drops to zero.
+    int32 ModificationBatchDepth = 0;
+
+    // Calls Visit for each chunk that may have vertices within Radius (2D) of Location,
+    // along with the rectangle of vertex coordinates worth scanning.
+    void ForEachChunkInRadius(const FVector& Location, float Radius,
+                              TFunctionRef<void(int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)> Visit);
+
+    // Calls Visit for each chunk overlapping an XY rectangle, along with the rectangle of vertex
+    // coordinates inside it.
+    void ForEachChunkInArea(const FBox2D& Area,
+                            TFunctionRef<void(int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex)> Visit);
+
+    // Queues a chunk for upload.
+    void MarkChunkDirty(int32 ChunkIndex, bool bGeometry, bool bLayers);
+
+    // Queues the neighbours of a chunk whose border normals sample the changed vertex rectangle.
+    void MarkNeighbourNormalsDirty(int32 ChunkIndex, const FIntPoint& MinVertex, const FIntPoint& MaxVertex);
+
+    // Uploads every dirty chunk with a single mesh section update each, unless a batch is open.
+    void FlushDirtyChunks();
+
+    // Derives the layer weights of a chunk's vertices from their height and slope.
+    void GenerateLayerWeights(const TArray<FVector>& Vertices, const TArray<FVector>& Normals, TArray<FColor>& OutWeights) const;
+
+    // Blends Amount (0-1) of a layer into packed weights, keeping their sum at 255.
+    static void BlendLayerWeight(FColor& Weights, ETerrainLayer Layer, float Amount);
+
+    // Number of vertices along X and Y of the whole terrain (chunks share their border vertices).
+    FIntPoint GetHeightfieldSize() const;
+
+    // Samples the height of every terrain vertex into one grid and applies the optional erosion.
+    // Prebaked or previously cached heights are loaded instead when present.
+    void GenerateHeightfield(TArray<float>& OutHeights) const;
+
+    // Computes normals and tangents analytically from the height gradient in a single pass.
+    // Samples beyond the chunk's edge are read through SampleGridHeight (terrain grid coordinates).
+    void CalculateNormalsAndTangents(const FIntPoint& ChunkCoords, const TArray<FVector>& Vertices,
+                                     TFunctionRef<float(int32 GridX, int32 GridY)> SampleGridHeight,
+                                     TArray<FVector>& Normals, TArray<FProcMeshTangent>& Tangents) const;
 
-    // Helper function to calculate normals for proper lighting.
-    void CalculateNormals(const TArray<FVector>& Vertices, const TArray<int32>& Triangles, TArray<FVector>& Normals) const;
+    // Height of a terrain grid vertex read from the chunk data, clamped to the terrain.
+    float GetGridHeight(int32 GridX, int32 GridY) const;
 
     // Calculates the chunks center position in world space based on grid coordinates.
     FVector CalculateChunkCenter(int32 ChunkX, int32 ChunkY, float HalfWorldSizeX, float HalfWorldSizeY, float ChunkWorldSize) const;
 
-    // Generates mesh data (vertices, UVs, triangles) for a terrain chunk section.
-    // The vertices are centered relative to the chunk center.
-    void GenerateMeshData(const FVector& ChunkCenter, TArray<FVector>& Vertices, TArray<FVector2D>& UVs, TArray<int32>& Triangles) const;
+    // Generates mesh data (vertices, triangles) for a terrain chunk section. UVs are shared by all chunks.
+    // The vertices are centered relative to the chunk center and take their heights from the heightfield.
+    void GenerateMeshData(const FVector& ChunkCenter, const FIntPoint& ChunkCoords, const TArray<float>& Heightfield,
+                          TArray<FVector>& Vertices, TArray<int32>& Triangles) const;
 };
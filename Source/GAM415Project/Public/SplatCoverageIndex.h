@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+// Paint coverage over world space, kept in a sparse hash of cubic cells.
+// Each hit stamps the cells under its disc on the hit surface with the team that painted them last,
+// so a cell belongs to one team per surface. Per-team totals for the whole world and for each
+// surface are updated as cells change hands, which makes those queries independent of how much
+// paint there is; region queries visit only the cells inside the region.
+class GAM415PROJECT_API FSplatCoverageIndex
+{
+public:
+    // Largest team index a cell can record.
+    static constexpr int32 MaxTeams = 255;
+
+    // Clears all coverage and sets the cell edge length. Coverage areas are counted in whole cells.
+    void Init(float InCellSize);
+
+    bool IsInitialized() const { return CellSize > 0.0f; }
+
+    float GetCellSize() const { return CellSize; }
+
+    // Paints the disc of Radius around Location, lying in the plane given by Normal, for a team.
+    // Returns the number of cells that changed team.
+    int32 AddHit(const FObjectKey& Surface, const FVector& Location, const FVector& Normal, float Radius, int32 TeamIndex);
+
+    // Area painted by a team across all surfaces.
+    float GetTeamArea(int32 TeamIndex) const;
+
+    // Area painted on a surface by each team, indexed by team.
+    void GetSurfaceCoverage(const FObjectKey& Surface, TArray<float>& OutAreaPerTeam) const;
+
+    // Area painted by each team within a world space box, indexed by team.
+    void GetRegionCoverage(const FBox& Region, TArray<float>& OutAreaPerTeam) const;
+
+    // Number of painted cells across all surfaces.
+    int32 GetNumPaintedCells() const { return NumPaintedCells; }
+
+    // Bytes held by the hash and the totals.
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    // The team that last painted a surface within a cell.
+    struct FCellEntry
+    {
+        FObjectKey Surface;
+        uint8 TeamIndex;
+    };
+
+    // Surfaces painted within one cell; almost always a single one.
+    using FCell = TArray<FCellEntry, TInlineAllocator<1>>;
+
+    // Cell containing a world position.
+    FIntVector GetCellCoord(const FVector& Location) const;
+
+    // Gives a surface's entry in a cell to a team. Returns true if it changed team.
+    bool PaintCell(const FIntVector& Coord, const FObjectKey& Surface, uint8 TeamIndex);
+
+    // Adds Delta painted cells for a team to a counter array, growing it as needed.
+    static void AddTeamCells(TArray<int32>& Counts, int32 TeamIndex, int32 Delta);
+
+    // Converts per-team cell counts to areas.
+    void CellsToArea(const TArray<int32>& Counts, TArray<float>& OutAreaPerTeam) const;
+
+    // Edge length of a cell; 0 until initialized.
+    float CellSize = 0.0f;
+
+    // Painted cells by coordinate.
+    TMap<FIntVector, FCell> Cells;
+
+    // Painted cells per team over all surfaces.
+    TArray<int32> TeamCells;
+
+    // Painted cells per team on each surface.
+    TMap<FObjectKey, TArray<int32>> SurfaceTeamCells;
+
+    // Number of (cell, surface) entries.
+    int32 NumPaintedCells = 0;
+};
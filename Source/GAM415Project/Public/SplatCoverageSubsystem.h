@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SplatCoverageIndex.h"
+#include "SplatCoverageSubsystem.generated.h"
+
+// Records every splat that leaves paint in a coverage index so game modes can ask how much of a
+// surface, a region or the whole level each team has painted. Teams are keyed on the shooter: game
+// modes put shooters on teams with SetShooterTeam, and any other shooter gets a team of its own
+// the first time it paints.
+UCLASS()
+class GAM415PROJECT_API USplatCoverageSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Coverage is only scored in game worlds.
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+    // Records a splat of Radius painted on Surface by a team.
+    void AddHit(const AActor* Surface, const FVector& Location, const FVector& Normal, float Radius, int32 TeamIndex);
+
+    // Returns the team a shooter paints for, giving a shooter without one the next free team.
+    // Shots without a shooter share one team. Returns INDEX_NONE once every team is taken.
+    UFUNCTION(BlueprintCallable, Category = "Splat|Coverage")
+    int32 GetShooterTeam(const AActor* Shooter);
+
+    // Puts a shooter on a team. Paint it already left stays with its previous team.
+    UFUNCTION(BlueprintCallable, Category = "Splat|Coverage")
+    void SetShooterTeam(const AActor* Shooter, int32 TeamIndex);
+
+    // Number of teams in use, counting up to the highest team index assigned.
+    UFUNCTION(BlueprintCallable, Category = "Splat|Coverage")
+    int32 GetNumTeams() const { return NumTeams; }
+
+    // Area painted by a team across the level.
+    UFUNCTION(BlueprintCallable, Category = "Splat|Coverage")
+    float GetTeamArea(int32 TeamIndex) const;
+
+    // Area painted on a surface by each team, indexed by team.
+    UFUNCTION(BlueprintCallable, Category = "Splat|Coverage")
+    void GetSurfaceCoverage(const AActor* Surface, TArray<float>& OutAreaPerTeam) const;
+
+    // Area painted by each team inside a world space box, indexed by team.
+    UFUNCTION(BlueprintCallable, Category = "Splat|Coverage")
+    void GetRegionCoverage(const FBox& Region, TArray<float>& OutAreaPerTeam) const;
+
+    // Clears all coverage, keeping the shooters' teams.
+    UFUNCTION(BlueprintCallable, Category = "Splat|Coverage")
+    void ResetCoverage();
+
+    const FSplatCoverageIndex& GetIndex() const { return Index; }
+
+private:
+    FSplatCoverageIndex Index;
+
+    // Team of each shooter that has painted or was assigned one.
+    TMap<FObjectKey, int32> ShooterTeams;
+
+    int32 NumTeams = 0;
+};
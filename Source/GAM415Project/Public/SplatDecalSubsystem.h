@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SplatDecalSubsystem.generated.h"
+
+class UDecalComponent;
+class UMaterialInstanceDynamic;
+class UMaterialInterface;
+class UTexture2D;
+
+// Look and lifetime of one splat decal.
+struct FSplatDecalParams
+{
+    UMaterialInterface* Material = nullptr;
+    FLinearColor Color = FLinearColor::White;
+
+    // Slice of a texture array sampled by Material, passed in the decal color's alpha (Variant / 255).
+    // Decals using it share Material without a dynamic instance.
+    int32 Variant = INDEX_NONE;
+
+    // Texture set on a per-decal dynamic material instance, used when there is no Variant.
+    UTexture2D* Texture = nullptr;
+
+    // Decal extent.
+    float Size = 64.0f;
+
+    // Seconds before the decal disappears; 0 keeps it until it is recycled.
+    float Lifetime = 10.0f;
+
+    // Fade out length, starting from the end of its lifetime.
+    float FadeOutLength = 1.0f;
+};
+
+// A decal component owned by the splat decal subsystem.
+USTRUCT()
+struct FSplatDecalSlot
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TObjectPtr<UDecalComponent> Decal;
+
+    // Created once per slot and reused for every splat the slot shows, only for splats without a Variant.
+    UPROPERTY()
+    TObjectPtr<UMaterialInstanceDynamic> MaterialInstance;
+
+    // World time the current splat was placed or last merged into, and when it expires (0 = never).
+    double StartTime = 0.0;
+    double ExpireTime = 0.0;
+
+    float Size = 0.0f;
+    bool bActive = false;
+
+    // Bumped every time the slot shows a splat, so older recycle queue entries for it are skipped.
+    uint32 Serial = 0;
+};
+
+// A splat in the recycle queue: the slot and its Serial when the splat was placed or merged into.
+struct FSplatDecalRecycleEntry
+{
+    int32 SlotIndex = INDEX_NONE;
+    uint32 Serial = 0;
+};
+
+// Places splat decals within a fixed global budget. Decal components live in a fixed pool: once
+// the budget is reached the oldest splat's component is moved to the new hit instead of spawning
+// another, and a splat landing on top of a live one refreshes it instead of stacking a new decal.
+// The number of decals the deferred renderer draws therefore never exceeds Splat.DecalBudget.
+UCLASS()
+class GAM415PROJECT_API USplatDecalSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Splats only appear in game worlds.
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Shows a splat decal at a hit, merging it into a live splat at nearly the same spot.
+    void AddSplat(const FHitResult& Hit, const FSplatDecalParams& Params);
+
+    // Number of splat decals currently visible.
+    int32 GetNumActiveDecals() const;
+
+private:
+    // Finds a live splat close enough to merge with, or INDEX_NONE.
+    int32 FindMergeSlot(const FVector& Location, const FVector& Normal, float Size) const;
+
+    // Returns the slot for a new splat: an expired one, then a fresh one while under budget,
+    // otherwise the one placed or merged into longest ago. Constant time per splat.
+    int32 AllocateSlot();
+
+    // Gives a slot a registered decal component, replacing one that was destroyed.
+    void CreateDecal(FSplatDecalSlot& Slot);
+
+    // Shows the splat in a slot, restarting its lifetime and fade.
+    void ShowSplat(FSplatDecalSlot& Slot, const FVector& Location, const FRotator& Rotation, const FSplatDecalParams& Params);
+
+    // Drops slots beyond the current budget.
+    void TrimToBudget(int32 Budget);
+
+    // Decal components, at most Splat.DecalBudget of them.
+    UPROPERTY()
+    TArray<FSplatDecalSlot> Slots;
+
+    // Slots whose splat expired, reused before any live splat is recycled.
+    TArray<int32> FreeSlots;
+
+    // Live splats in the order they were placed or merged into, oldest at RecycleHead.
+    TArray<FSplatDecalRecycleEntry> RecycleQueue;
+    int32 RecycleHead = 0;
+
+    // Owner of the decal components.
+    UPROPERTY()
+    TObjectPtr<AActor> DecalActor;
+};
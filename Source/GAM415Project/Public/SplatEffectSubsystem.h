@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SplatEffectSubsystem.generated.h"
+
+class UNiagaraSystem;
+
+// A splat impact waiting for its effect.
+USTRUCT()
+struct FSplatEffectRequest
+{
+    GENERATED_BODY()
+
+    // Effect spawned for this impact alone.
+    UPROPERTY()
+    TObjectPtr<UNiagaraSystem> System;
+
+    // Optional effect that bursts at every impact of a frame at once (see USplatEffectSubsystem).
+    UPROPERTY()
+    TObjectPtr<UNiagaraSystem> AggregateSystem;
+
+    FVector Location = FVector::ZeroVector;
+    FVector Normal = FVector::UpVector;
+    FLinearColor Color = FLinearColor::White;
+};
+
+// Spawns splat impact effects once per frame from pooled Niagara components.
+// Impacts farther than Splat.EffectCullDistance from every local player's view are dropped, and at
+// most Splat.EffectBudget systems are spawned per frame, nearest impacts first. Impacts whose class
+// provides an aggregate system are merged into one spawn per system per frame, which receives the
+// impacts through the "ImpactPositions", "ImpactNormals" and "ImpactColors" array parameters and
+// their count in "ImpactCount".
+UCLASS()
+class GAM415PROJECT_API USplatEffectSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Effects only play in game worlds.
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Queues the effect of an impact; it is spawned, merged or culled on the next tick.
+    void AddImpact(const FSplatEffectRequest& Request);
+
+    // Number of systems spawned and impacts dropped since the world started.
+    int64 GetNumSpawned() const { return NumSpawned; }
+    int64 GetNumCulled() const { return NumCulled; }
+
+private:
+    // Spawns one pooled component for a single impact.
+    void SpawnSingle(const FSplatEffectRequest& Request);
+
+    // Spawns one pooled component bursting at every given impact.
+    void SpawnAggregate(UNiagaraSystem* System, TConstArrayView<const FSplatEffectRequest*> Requests);
+
+    // Impacts queued since the last tick.
+    UPROPERTY()
+    TArray<FSplatEffectRequest> PendingImpacts;
+
+    int64 NumSpawned = 0;
+    int64 NumCulled = 0;
+};
@@ -13,6 +13,7 @@ class UProjectileMovementComponent;
 class UMaterialInterface;
 class UDecalComponent;
 class UNiagaraSystem;
+class UTexture2DArray;
 
 UCLASS()
 class GAM415PROJECT_API ASplatProjectile : public AActor
@@ -22,9 +23,64 @@ class GAM415PROJECT_API ASplatProjectile : public AActor
 public:
     ASplatProjectile();
 
+    // Applies a hit with this projectile's settings: a decal on static geometry, an impulse on
+    // physics bodies, and the splat effect. Used by live projectiles and, on the class default
+    // object, by USplatProjectileSubsystem for projectiles simulated without an actor.
+    // ShotSeed picks the splat texture, so the same shot always leaves the same splat. Paint left
+    // on terrain or static geometry counts toward TeamIndex's coverage (INDEX_NONE for none).
+    void ApplyImpact(UWorld* World, const FHitResult& Hit, const FVector& Velocity, const FLinearColor& Color,
+                     int32 ShotSeed, int32 TeamIndex) const;
+
+    // Seed of one shot, combining its shooter's seed with the shot's index. Every random choice
+    // about a shot derives from it, so a shooter seed and shot index reproduce the shot exactly.
+    static int32 MakeShotSeed(int32 ShooterSeed, int32 ShotIndex);
+
+    // Paint color of the shot with this seed.
+    static FLinearColor GetShotColor(int32 ShotSeed);
+
+    // Sets the seed of a projectile spawned deferred, before BeginPlay picks its color.
+    void SetShotSeed(int32 InShotSeed);
+
+    // Speed the projectile is fired at.
+    float GetInitialSpeed() const;
+
+    // Gravity scale applied to the projectile in flight.
+    float GetGravityScale() const;
+
+    // Radius of the collision sphere.
+    float GetCollisionRadius() const;
+
+    // How long a simulated projectile may fly without hitting anything; 0 means no limit was set.
+    float GetSimulatedLifetime() const { return InitialLifeSpan; }
+
+    // Static mesh drawn for the projectile.
+    UStaticMesh* GetProjectileMesh() const;
+
+    // Material for instanced rendering, falling back to the mesh's own material.
+    UMaterialInterface* GetInstancedMaterial() const;
+
+    // Blueprint subclasses with their own logic set this, so the subsystem spawns real actors for them.
+    bool RequiresActor() const { return bRequiresActor; }
+
+    // Puts a pooled projectile back in flight as a new shot.
+    void ActivateFromPool(const FVector& Location, const FRotator& Rotation, int32 InShotSeed);
+
+    // Hides and stops the projectile so it can wait in USplatProjectileSubsystem's pool.
+    void DeactivateToPool();
+
+    // Pooled projectiles return to the pool when their life span runs out.
+    virtual void LifeSpanExpired() override;
+
 protected:
     virtual void BeginPlay() override;
 
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+    // Copies SplatTextures into SplatTextureArray's source slices and rebuilds it.
+    void RebuildSplatTextureArray();
+#endif
+
     // Collision component (root)
     UPROPERTY(VisibleAnywhere, Category = "Components")
     USphereComponent* CollisionSphere;
@@ -61,12 +117,46 @@ protected:
     UPROPERTY(EditDefaultsOnly, Category = "Decal")
     TArray<UTexture2D*> SplatTextures;
 
+    // SplatTextures packed into one texture array, rebuilt in the editor whenever either changes.
+    // When set, every decal shares DecalMaterial without a dynamic instance: the material reads the
+    // color from Decal Color RGB and the array slice from Decal Color alpha (slice / 255).
+    UPROPERTY(EditDefaultsOnly, Category = "Decal")
+    UTexture2DArray* SplatTextureArray;
+
     UPROPERTY(EditDefaultsOnly, Category = "Effects")
     UNiagaraSystem* NiagaraSplatEffect;
 
+    // Optional system that bursts at every impact of a frame in one spawn, reading the impacts from
+    // the "ImpactPositions", "ImpactNormals" and "ImpactColors" arrays. Replaces NiagaraSplatEffect when set.
+    UPROPERTY(EditDefaultsOnly, Category = "Effects")
+    UNiagaraSystem* NiagaraAggregateSplatEffect;
+
+    // Material used when the projectile subsystem draws this class as instances. It should read the
+    // color from per-instance custom data 0-2, since instances have no dynamic material.
+    UPROPERTY(EditDefaultsOnly, Category = "Simulation")
+    UMaterialInterface* InstancedMaterial;
+
+    // Spawns a real actor per shot instead of an instanced record, for subclasses whose Blueprint
+    // logic needs one (events, timelines, attached components).
+    UPROPERTY(EditDefaultsOnly, Category = "Simulation")
+    bool bRequiresActor = false;
+
     // Color value for both projectile and decal
     FLinearColor ProjectileColor;
 
+    // Seed of the current shot, and whether one was given before BeginPlay.
+    int32 ShotSeed = 0;
+    bool bHasShotSeed = false;
+
+    // Set once the projectile belongs to the actor pool; it is returned there instead of destroyed.
+    bool bPooled = false;
+
+    // Sets the projectile color, reusing the dynamic material.
+    void SetProjectileColor(const FLinearColor& Color);
+
+    // Ends the projectile's flight after a hit or when its life span runs out.
+    void FinishFlight();
+
     // Processes collision hit
     UFUNCTION()
     void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor,
@@ -74,11 +164,11 @@ protected:
                const FHitResult& Hit);
 
     // Applies force to physics object
-    void ApplyForce(UPrimitiveComponent* OtherComp);
+    void ApplyForce(UPrimitiveComponent* OtherComp, const FVector& Velocity, const FVector& Location) const;
 
     // Spawns Niagara splat effect
-    void SpawnEffect(const FHitResult& Hit);
+    void SpawnEffect(UWorld* World, const FHitResult& Hit, const FLinearColor& Color) const;
 
-    // Spawns decal to represent the splat
-    void SpawnSplatDecal(const FHitResult& Hit);
+    // Spawns decal to represent the splat. Returns false when the class has no decal to show.
+    bool SpawnSplatDecal(UWorld* World, const FHitResult& Hit, const FLinearColor& Color, int32 InShotSeed) const;
 };
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "SplatProjectileSubsystem.generated.h"
+
+class APortal;
+class ASplatProjectile;
+class UInstancedStaticMeshComponent;
+
+// All simulated projectiles of one ASplatProjectile class, stored as parallel arrays.
+USTRUCT()
+struct FSplatProjectileBatch
+{
+    GENERATED_BODY()
+
+    // Class whose defaults configure the projectiles (mesh, speed, decals, effects).
+    UPROPERTY()
+    TSubclassOf<ASplatProjectile> ProjectileClass;
+
+    // Projectiles are dropped after flying this long without a hit.
+    float Lifetime = 0.0f;
+
+    // Draws every projectile of the batch; instance i is projectile i, colored by custom data 0-2.
+    UPROPERTY()
+    TObjectPtr<UInstancedStaticMeshComponent> Instances;
+
+    TArray<FVector> Positions;
+    TArray<FVector> Velocities;
+    TArray<FLinearColor> Colors;
+    TArray<int32> ShotSeeds;
+
+    // Coverage team of each projectile's shooter, fixed when it is fired.
+    TArray<int32> TeamIndices;
+    TArray<float> Ages;
+
+    // Hit found by this frame's sweep, per projectile. Scratch space reused every tick.
+    TArray<FHitResult> Hits;
+    TArray<uint8> bHit;
+
+    // Portal entered this frame before anything was hit, per projectile. Scratch space reused every tick.
+    TArray<const APortal*> EnteredPortals;
+
+    int32 Num() const { return Positions.Num(); }
+
+    // Removes projectile Index by swapping the last one into its place.
+    void RemoveAtSwap(int32 Index);
+};
+
+// Inactive projectile actors of one class, waiting to be fired again.
+USTRUCT()
+struct FSplatProjectilePool
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<TObjectPtr<ASplatProjectile>> Inactive;
+};
+
+// Shot counter of one shooter. Shot N's seed is ASplatProjectile::MakeShotSeed(Seed, N).
+struct FSplatShooterSeed
+{
+    int32 Seed = 0;
+    int32 NextShotIndex = 0;
+};
+
+// Simulates splat projectiles without an actor per projectile. Projectiles are plain records that
+// move under gravity, sweep for hits in one parallel batch per tick, and render through a single
+// instanced static mesh per projectile class. Classes that set bRequiresActor still get real actors,
+// which are recycled through a per-class pool instead of destroyed (see Splat.PoolActors).
+UCLASS()
+class GAM415PROJECT_API USplatProjectileSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Projectiles only fly in game worlds.
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Fires a projectile of the given class along Rotation at the class's initial speed, as the
+    // shooter's next shot. Returns the spawned actor when the class requires one, null when it is simulated.
+    UFUNCTION(BlueprintCallable, Category = "Splat", meta = (DeterminesOutputType = "ProjectileClass"))
+    ASplatProjectile* FireSplatProjectile(TSubclassOf<ASplatProjectile> ProjectileClass, const FVector& Location,
+                                          const FRotator& Rotation, AActor* Shooter = nullptr);
+
+    // Fires a projectile whose color and splat are fixed by ShotSeed, e.g. a shot replicated from
+    // another machine or read back from a recording.
+    ASplatProjectile* FireSplatProjectileWithSeed(TSubclassOf<ASplatProjectile> ProjectileClass, const FVector& Location,
+                                                  const FRotator& Rotation, AActor* Shooter, int32 ShotSeed);
+
+    // Restarts a shooter's shots from a seed, so they repeat those of a recorded or remote session.
+    UFUNCTION(BlueprintCallable, Category = "Splat")
+    void SetShooterSeed(const AActor* Shooter, int32 Seed, int32 NextShotIndex = 0);
+
+    // Seed and index of the shooter's next shot. Shooters start from Splat.RandomSeed and their name.
+    UFUNCTION(BlueprintCallable, Category = "Splat")
+    void GetShooterSeed(const AActor* Shooter, int32& OutSeed, int32& OutNextShotIndex);
+
+    // Returns the seed of the shooter's next shot and advances its shot index.
+    int32 AdvanceShotSeed(const AActor* Shooter);
+
+    // Number of projectiles currently simulated without actors.
+    int32 GetNumSimulatedProjectiles() const;
+
+    // Puts a projectile actor in flight, taken from the pool when bUsePool is set, or freshly spawned.
+    ASplatProjectile* AcquireProjectileActor(TSubclassOf<ASplatProjectile> ProjectileClass, const FVector& Location,
+                                             const FRotator& Rotation, AActor* Shooter, int32 ShotSeed, bool bUsePool);
+
+    // Deactivates a pooled projectile actor and keeps it for reuse.
+    void ReleaseProjectileActor(ASplatProjectile* Projectile);
+
+    // Spawns inactive projectile actors up front so firing never has to spawn.
+    UFUNCTION(BlueprintCallable, Category = "Splat")
+    void PrewarmActorPool(TSubclassOf<ASplatProjectile> ProjectileClass, int32 Count);
+
+private:
+    // Finds or creates the batch for a class, including its instanced mesh.
+    FSplatProjectileBatch& GetBatch(TSubclassOf<ASplatProjectile> ProjectileClass);
+
+    // Moves every projectile of a batch and sweeps its path in parallel, filling Hits, bHit and EnteredPortals.
+    void SimulateBatch(FSplatProjectileBatch& Batch, float DeltaTime) const;
+
+    // Applies hits, moves projectiles through the portals they entered, removes finished projectiles
+    // and pushes the instances to the renderer.
+    void ResolveBatch(FSplatProjectileBatch& Batch, float DeltaTime);
+
+    // Resizes the batch's instances to match its projectiles and uploads transforms and colors.
+    static void UpdateInstances(FSplatProjectileBatch& Batch);
+
+    // One batch per fired projectile class.
+    UPROPERTY()
+    TArray<FSplatProjectileBatch> Batches;
+
+    // Spawns a projectile actor and immediately parks it in the pool.
+    ASplatProjectile* SpawnPooledActor(TSubclassOf<ASplatProjectile> ProjectileClass);
+
+    // Inactive projectile actors per class.
+    UPROPERTY()
+    TMap<TSubclassOf<ASplatProjectile>, FSplatProjectilePool> ActorPools;
+
+    // Finds a shooter's shot counter, seeding it on first use.
+    FSplatShooterSeed& FindOrAddShooterSeed(const AActor* Shooter);
+
+    // Shot counters per shooter; shots without a shooter share one.
+    TMap<FObjectKey, FSplatShooterSeed> ShooterSeeds;
+
+    // Owner of the instanced mesh components.
+    UPROPERTY()
+    TObjectPtr<AActor> RenderActor;
+
+    // Linked portals projectiles can pass through this tick. Scratch space reused every tick.
+    TArray<const APortal*> Portals;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TerrainBakeCommandlet.generated.h"
+
+struct FTerrainGenerationParams;
+
+// Generates terrain heightfields headless and writes them to the prebaked height cache,
+// so cooked builds load them instead of running noise and erosion at startup.
+//
+// UnrealEditor-Cmd GAM415Project.uproject -run=TerrainBake -nullrhi [options]
+//   -Seeds=1,2,3          Seeds to bake (or -Seed=N). Defaults to the terrain actor's seed.
+//   -SetsFile=Path        Text file with one parameter set per line, using the switches below.
+//                         Each line is baked once per command line seed, unless it sets its own.
+//   -XSize= -YSize= -Scale= -HeightScale= -NoiseScale= -ChunkSize= -OriginX= -OriginY=
+//   -Erosion / -NoErosion Overrides the actor's erosion toggle.
+//   -Workers=N            Erosion worker count (0 lets the task graph pick).
+//   -Local                Writes to the runtime cache in Saved/ instead of Content/.
+UCLASS()
+class UTerrainBakeCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UTerrainBakeCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    // Applies the parameter switches found in a line of arguments on top of Base.
+    // Returns one parameter set per requested seed.
+    static void ParseParameterSets(const FString& Line, const FTerrainGenerationParams& Base,
+                                   TArray<FTerrainGenerationParams>& OutSets);
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainErosion.generated.h"
+
+// Tunables for the erosion stage that runs over generated terrain heights.
+// Hydraulic values work in grid units (heights are divided by the vertex spacing while eroding).
+USTRUCT(BlueprintType)
+struct FTerrainErosionSettings
+{
+    GENERATED_BODY()
+
+    // Number of erode/merge rounds. Droplets and thermal steps are split evenly across them,
+    // and neighbouring chunks exchange their changes after each one.
+    UPROPERTY(EditAnywhere, Category = "Erosion", meta = (ClampMin = "1"))
+    int32 Passes = 4;
+
+    // Water droplets simulated per chunk over the whole erosion.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "0"))
+    int32 DropletsPerChunk = 1000;
+
+    // Maximum steps a droplet travels; also sets the halo copied from neighbouring chunks.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "1", ClampMax = "64"))
+    int32 MaxDropletLifetime = 24;
+
+    // How much a droplet keeps its previous direction instead of following the slope.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float Inertia = 0.05f;
+
+    // Multiplier for how much sediment a droplet can carry.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "0.0"))
+    float SedimentCapacity = 4.0f;
+
+    // Carry capacity floor so droplets on flat ground still erode a little.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "0.0"))
+    float MinSedimentCapacity = 0.01f;
+
+    // Fraction of free capacity picked up per step.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float ErodeSpeed = 0.3f;
+
+    // Fraction of surplus sediment dropped per step.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float DepositSpeed = 0.3f;
+
+    // Fraction of water lost per step.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float EvaporateSpeed = 0.02f;
+
+    // Acceleration of droplets going downhill.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Hydraulic", meta = (ClampMin = "0.0"))
+    float Gravity = 4.0f;
+
+    // Thermal relaxation sweeps over the whole erosion.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Thermal", meta = (ClampMin = "0"))
+    int32 ThermalIterations = 8;
+
+    // Steepest slope (in degrees) material rests at before sliding down.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Thermal", meta = (ClampMin = "0.0", ClampMax = "89.0"))
+    float TalusAngle = 40.0f;
+
+    // Fraction of the excess slope moved per sweep.
+    UPROPERTY(EditAnywhere, Category = "Erosion|Thermal", meta = (ClampMin = "0.0", ClampMax = "0.5"))
+    float ThermalRate = 0.25f;
+};
+
+// Serializes every setting; used to key cached erosion results.
+FArchive& operator<<(FArchive& Ar, FTerrainErosionSettings& Settings);
+
+// Work done by one erosion run.
+struct FTerrainErosionStats
+{
+    int64 Droplets = 0;
+    int64 DropletSteps = 0;
+    int64 ThermalCellUpdates = 0;
+    double Seconds = 0.0;
+};
+
+// Particle-based hydraulic and thermal talus erosion over the chunked terrain heightfield.
+struct GAM415PROJECT_API FTerrainErosion
+{
+    // Erodes a heightfield of GridSize vertices (indexed X * GridSize.Y + Y) in place.
+    // Every chunk is a tile that runs in parallel on a private copy including a halo of its
+    // neighbours, and the tiles' changes are merged back after every pass. The result depends
+    // only on the inputs and Seed, not on NumWorkers (0 lets the task graph pick).
+    static FTerrainErosionStats Erode(TArray<float>& Heights, const FIntPoint& GridSize, int32 CellsPerChunk,
+                                      float CellSize, const FTerrainErosionSettings& Settings, int32 Seed,
+                                      int32 NumWorkers = 0);
+};
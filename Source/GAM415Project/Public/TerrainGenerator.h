@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainErosion.h"
+
+// Everything that determines a terrain heightfield. Filled from an AProceduralTerrain,
+// or from command line arguments when baking terrain headless.
+struct GAM415PROJECT_API FTerrainGenerationParams
+{
+    // World XY position of the terrain actor; noise is sampled in world space.
+    FVector2D Origin = FVector2D::ZeroVector;
+
+    float XSize = 10000.0f;
+    float YSize = 10000.0f;
+    float Scale = 100.0f;
+    float HeightScale = 500.0f;
+    float NoiseScale = 0.0005f;
+    int32 ChunkSize = 32;
+    int32 Seed = 0;
+
+    bool bEnableErosion = false;
+    FTerrainErosionSettings ErosionSettings;
+
+    // Number of chunks needed along X and Y.
+    FIntPoint GetNumChunks() const;
+
+    // Number of vertices along X and Y of the whole terrain (chunks share their border vertices).
+    FIntPoint GetHeightfieldSize() const;
+
+    // Hash of every field, used as the height cache key.
+    uint64 GetCacheKey() const;
+};
+
+// Produces terrain heightfields without needing a world or an actor.
+struct GAM415PROJECT_API FTerrainGenerator
+{
+    // Samples the noise height of every vertex (indexed X * Size.Y + Y) and erodes it when enabled.
+    static FTerrainErosionStats GenerateHeightfield(const FTerrainGenerationParams& Params, TArray<float>& OutHeights,
+                                                    int32 NumWorkers = 0);
+
+    // Uses Perlin noise to compute the height at a given world coordinate.
+    static float GetNoiseHeight(const FTerrainGenerationParams& Params, float WorldX, float WorldY);
+
+    // Noise space offset derived from the seed. Seed 0 keeps the unseeded layout.
+    static FVector2D GetNoiseOffset(int32 Seed);
+};
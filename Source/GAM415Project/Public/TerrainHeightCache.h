@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// On-disk cache of generated terrain heightfields, keyed by a hash of everything that shapes them
+// (seed, terrain parameters and erosion settings), so expensive generation runs only once.
+struct GAM415PROJECT_API FTerrainHeightCache
+{
+    // Directory holding cache files written at runtime.
+    static FString GetCacheDirectory();
+
+    // Directory holding cache files baked by the TerrainBake commandlet; staged with cooked builds.
+    static FString GetPrebakedDirectory();
+
+    // Full path of the cache file for a key, in the prebaked or runtime directory.
+    static FString GetCacheFilename(uint64 Key, bool bPrebaked = false);
+
+    // Loads the heights stored for a key, trying the prebaked directory first.
+    // Fails if no file exists, or it is corrupt or of another grid size.
+    static bool Load(uint64 Key, const FIntPoint& GridSize, TArray<float>& OutHeights);
+
+    // Writes the heights for a key, replacing any previous file.
+    static bool Save(uint64 Key, const FIntPoint& GridSize, TArray<float>& Heights, bool bPrebaked = false);
+
+private:
+    static bool LoadFile(const FString& Filename, const FIntPoint& GridSize, TArray<float>& OutHeights);
+};
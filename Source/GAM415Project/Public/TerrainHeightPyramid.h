@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/Interval.h"
+
+struct FConvexVolume;
+
+// Hierarchical min/max height pyramid over the chunked terrain heightfield.
+// Every chunk keeps a mip chain of min/max ranges over its grid cells, and a global
+// chain is built over the chunk ranges, so spatial queries can skip whole regions
+// without touching their vertices. All positions are in the terrain actor's local space.
+class GAM415PROJECT_API FTerrainHeightPyramid
+{
+public:
+    // Sets up the chunk grid layout and allocates every level.
+    // Origin is the local XY position of the first vertex of chunk (0, 0).
+    void Init(const FIntPoint& InNumChunks, int32 InChunkSize, float InScale, const FVector2D& InOrigin);
+
+    // Releases all pyramid data.
+    void Reset();
+
+    bool IsInitialized() const { return Chunks.Num() > 0; }
+
+    // Rebuilds all levels of a chunk from its vertices (laid out like FChunkData::Vertices).
+    void BuildChunk(int32 ChunkIndex, const TArray<FVector>& Vertices);
+
+    // Refreshes the levels covering the vertex rectangle [MinVertex, MaxVertex] of a chunk.
+    // Cost is proportional to the rectangle size plus the pyramid height, not the map size.
+    void UpdateChunkRegion(int32 ChunkIndex, const TArray<FVector>& Vertices, FIntPoint MinVertex, FIntPoint MaxVertex);
+
+    // Height of the triangulated surface at an XY position. Returns false outside the terrain.
+    bool GetHeightAt(const FVector2D& Location, float& OutHeight) const;
+
+    // Finds the closest intersection of the segment with the terrain surface.
+    bool Raycast(const FVector& Start, const FVector& End, FVector& OutHitLocation, FVector& OutHitNormal) const;
+
+    // Returns true if any part of the terrain surface lies within the sphere.
+    bool OverlapSphere(const FVector& Center, float Radius) const;
+
+    // Collects the indices of chunks whose bounds intersect a world space frustum.
+    void GetChunksInFrustum(const FConvexVolume& Frustum, const FTransform& LocalToWorld, TArray<int32>& OutChunkIndices) const;
+
+    // Bounds of a chunk, including its current height range.
+    FBox GetChunkBounds(int32 ChunkIndex) const;
+
+    // Height range of the whole terrain.
+    FFloatInterval GetHeightRange() const;
+
+private:
+    // Per-chunk height samples and min/max levels.
+    struct FChunkLevels
+    {
+        // Vertex heights, indexed like FChunkData::Vertices (X * ChunkSize + Y).
+        TArray<float> Heights;
+
+        // Min/max ranges per level; level 0 holds one range per grid cell.
+        TArray<TArray<FFloatInterval>> Levels;
+    };
+
+    // Recomputes chunk nodes in [MinNode, MaxNode] of a level from the level below (or the heights).
+    void RebuildChunkNodes(FChunkLevels& Chunk, int32 Level, const FIntPoint& MinNode, const FIntPoint& MaxNode) const;
+
+    // Propagates a chunk's root range up through the global levels.
+    void RefreshGlobalNodes(int32 ChunkIndex);
+
+    // Local space bounds of a node in a global level.
+    FBox GetGlobalNodeBounds(int32 Level, int32 X, int32 Y, const FFloatInterval& Range) const;
+
+    // Local space bounds of a node in a chunk level.
+    FBox GetChunkNodeBounds(int32 ChunkIndex, int32 Level, int32 X, int32 Y, const FFloatInterval& Range) const;
+
+    // Fills the four corner positions of a grid cell (00, 01, 10, 11).
+    void GetCellCorners(int32 ChunkIndex, int32 CellX, int32 CellY, FVector OutCorners[4]) const;
+
+    // Walks the pyramid top-down, descending only into nodes whose bounds pass ShouldVisit.
+    // Visit is called for each accepted grid cell; returning false from it stops the walk.
+    void VisitCells(TFunctionRef<bool(const FBox&)> ShouldVisit,
+                    TFunctionRef<bool(int32 ChunkIndex, int32 CellX, int32 CellY)> Visit) const;
+
+    bool VisitGlobalNode(int32 Level, int32 X, int32 Y,
+                         TFunctionRef<bool(const FBox&)> ShouldVisit,
+                         TFunctionRef<bool(int32, int32, int32)> Visit) const;
+
+    bool VisitChunkNode(int32 ChunkIndex, int32 Level, int32 X, int32 Y,
+                        TFunctionRef<bool(const FBox&)> ShouldVisit,
+                        TFunctionRef<bool(int32, int32, int32)> Visit) const;
+
+    // Number of chunks along X and Y.
+    FIntPoint NumChunks = FIntPoint::ZeroValue;
+
+    // Vertices per chunk side; a chunk has (ChunkSize - 1)^2 cells.
+    int32 ChunkSize = 0;
+
+    // Spacing between vertices.
+    float Scale = 1.0f;
+
+    // Local XY position of the first vertex of chunk (0, 0).
+    FVector2D Origin = FVector2D::ZeroVector;
+
+    // Nodes per side of each chunk level.
+    TArray<int32> ChunkLevelSizes;
+
+    // Height data and levels of every chunk, indexed like the terrain's chunk array.
+    TArray<FChunkLevels> Chunks;
+
+    // Node counts of each global level; level 0 holds one range per chunk.
+    TArray<FIntPoint> GlobalLevelSizes;
+
+    // Min/max ranges per global level, indexed X * Size.Y + Y.
+    TArray<TArray<FFloatInterval>> GlobalLevels;
+};
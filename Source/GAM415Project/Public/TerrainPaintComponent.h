@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Tasks/Task.h"
+#include "TerrainPaintComponent.generated.h"
+
+class UMaterialInstanceDynamic;
+class UTexture2D;
+
+// Persistent paint accumulated over a surface in its local XY space.
+// Hits are queued on the game thread and rasterized once per frame on a worker into a CPU texel
+// buffer split into square tiles. Only the tiles a frame touched are uploaded to the paint texture,
+// so memory and render cost stay fixed however much paint lands. Without a renderer (-nullrhi)
+// the texture is skipped and the CPU buffer still answers coverage queries.
+UCLASS(ClassGroup = (Rendering), meta = (BlueprintSpawnableComponent))
+class GAM415PROJECT_API UTerrainPaintComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UTerrainPaintComponent();
+
+    // Texels per world unit along X and Y.
+    UPROPERTY(EditAnywhere, Category = "Paint", meta = (ClampMin = "0.001"))
+    float TexelsPerUnit = 0.1f;
+
+    // Largest paint texture side; the density drops for surfaces that would exceed it.
+    UPROPERTY(EditAnywhere, Category = "Paint", meta = (ClampMin = "32", ClampMax = "4096"))
+    int32 MaxResolution = 2048;
+
+    // Lays the paint layer over a local XY rectangle and clears it.
+    // Material receives the "PaintTexture" and "PaintBounds" (min X, min Y, size X, size Y) parameters.
+    void Init(const FBox2D& InLocalBounds, UMaterialInstanceDynamic* InMaterial);
+
+    // Whether Init has laid out the paint layer. Paint added before then is dropped.
+    bool IsInitialized() const { return !Texels.IsEmpty(); }
+
+    // Queues a round splat of paint at a world location. Applied on the next tick.
+    UFUNCTION(BlueprintCallable, Category = "Paint")
+    void AddPaint(const FVector& WorldLocation, float Radius, const FLinearColor& Color);
+
+    // Waits for queued paint to be rasterized, so the CPU buffer is up to date.
+    UFUNCTION(BlueprintCallable, Category = "Paint")
+    void FlushPaint();
+
+    // Fraction of the surface covered by any paint (0-1).
+    UFUNCTION(BlueprintCallable, Category = "Paint")
+    float GetPaintedFraction();
+
+    // Fraction of the surface whose paint is within Tolerance (per channel) of Color.
+    UFUNCTION(BlueprintCallable, Category = "Paint")
+    float GetColorCoverage(const FLinearColor& Color, float Tolerance = 0.05f);
+
+    // Size of the paint texture in texels.
+    FIntPoint GetResolution() const { return Resolution; }
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void OnUnregister() override;
+
+private:
+    // A queued splat in texel space.
+    struct FPaintStamp
+    {
+        FVector2f Center;
+        float Radius;
+        FColor Color;
+    };
+
+    // Rasterizes stamps into Texels and marks the touched tiles. Runs on a worker.
+    void RasterizeStamps(const TArray<FPaintStamp>& Stamps);
+
+    // Uploads the tiles dirtied by the last finished rasterization.
+    void UploadDirtyTiles();
+
+    // Starts rasterizing the stamps queued since the last tick.
+    void LaunchRasterization();
+
+    // Creates the paint texture the first time something is uploaded.
+    void CreatePaintTexture();
+
+    // Texels per tile side.
+    static constexpr int32 TileSize = 32;
+
+    // Local XY rectangle covered by the paint.
+    FBox2D LocalBounds = FBox2D(ForceInit);
+
+    FIntPoint Resolution = FIntPoint::ZeroValue;
+    FIntPoint NumTiles = FIntPoint::ZeroValue;
+
+    // CPU copy of the paint, row major. Only the raster task touches it while one is in flight.
+    TArray<FColor> Texels;
+
+    // One flag per tile, set by the raster task and cleared by the upload.
+    TBitArray<> DirtyTiles;
+
+    // Number of texels with any paint, kept up to date incrementally.
+    int64 NumPaintedTexels = 0;
+
+    // Stamps queued on the game thread since the last launch.
+    TArray<FPaintStamp> PendingStamps;
+
+    // Rasterization of the previous frame's stamps.
+    UE::Tasks::FTask RasterTask;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UTexture2D> PaintTexture;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UMaterialInstanceDynamic> PaintMaterial;
+};